@@ -0,0 +1,69 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  arena.cpp
+ *
+ *    Description:  Implementation of the arena allocator
+ *
+ *        Version:  1.0
+ *        Created:  19/10/2026 15:41:07
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  François Hissel
+ *   Organization:
+ *
+ * =====================================================================================
+ */
+
+#include <new>
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include "arena.h"
+
+using namespace std;
+
+/*********************************************
+ *                  Arena                    *
+ *********************************************/
+Arena::~Arena() {
+	for (auto &it:_blocks) ::operator delete(it.data);
+}
+
+void Arena::reset() noexcept {
+	_current=0;
+	_ptr=_end=nullptr;
+	_used=0;
+}
+
+size_t Arena::capacity() const noexcept {
+	size_t res=0;
+	for (const auto &it:_blocks) res+=it.size;
+	return res;
+}
+
+void *Arena::do_allocate(size_t bytes,size_t alignment) {
+	for (;;) {
+		if (_ptr!=nullptr) {
+			auto padding=(alignment-reinterpret_cast<uintptr_t>(_ptr)%alignment)%alignment;
+			if (padding+bytes<=size_t(_end-_ptr)) {
+				void *res=_ptr+padding;
+				_ptr+=padding+bytes;
+				_used+=padding+bytes;
+				return res;
+			}
+		}
+		// Move to the next block which is large enough, or append a new one. Skipped blocks are used again after the next reset
+		auto needed=bytes+alignment;
+		while (_current<_blocks.size() && _blocks[_current].size<needed) ++_current;
+		if (_current==_blocks.size()) {
+			auto size=max(_block_size,needed);
+			_blocks.push_back(Block{static_cast<char*>(::operator new(size)),size});
+		}
+		_ptr=_blocks[_current].data;
+		_end=_ptr+_blocks[_current].size;
+		++_current;
+	}
+}
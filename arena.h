@@ -0,0 +1,87 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  arena.h
+ *
+ *    Description:  Bump allocator holding the data of a document, freed all at once
+ *
+ *        Version:  1.0
+ *        Created:  19/10/2026 15:20:44
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  François Hissel
+ *   Organization:
+ *
+ * =====================================================================================
+ */
+
+#ifndef  ARENA_INC
+#define  ARENA_INC
+
+#include <memory_resource>
+#include <vector>
+#include <cstddef>
+
+/**
+ * \brief Arena allocator
+ *
+ * Memory is handed out from large blocks by bumping a pointer, and individual deallocations do nothing. All the allocations are freed at once by a reset, which keeps the blocks for the next document, so that an arena reused for many documents stops calling the system allocator once it has grown to the size of the largest one. The arena is a polymorphic memory resource, usable with the std::pmr containers. It is not thread-safe: each thread uses its own arena.
+ */
+class Arena:public std::pmr::memory_resource {
+	public:
+		/**
+		 * \brief Create an empty arena
+		 *
+		 * \param block_size Size of the blocks requested from the system allocator. Larger allocations get a block of their own
+		 */
+		explicit Arena(std::size_t block_size=65536) noexcept:_block_size(block_size),_current(0),_ptr(nullptr),_end(nullptr),_used(0) {}
+
+		Arena(const Arena&)=delete; 	//!< An arena can not be copied
+		Arena& operator=(const Arena&)=delete; 	//!< An arena can not be copied
+
+		/**
+		 * \brief Destroy the arena and free its blocks
+		 */
+		~Arena() override;
+
+		/**
+		 * \brief Free all the allocations at once
+		 *
+		 * The blocks are kept and reused by the next allocations. The objects allocated in the arena must not be used anymore.
+		 */
+		void reset() noexcept;
+
+		/**
+		 * \brief Number of bytes allocated since the last reset, including the padding required by the alignments
+		 */
+		std::size_t used() const noexcept {return _used;}
+
+		/**
+		 * \brief Total size of the blocks owned by the arena, in bytes
+		 */
+		std::size_t capacity() const noexcept;
+
+	protected:
+		void *do_allocate(std::size_t bytes,std::size_t alignment) override;
+		void do_deallocate(void*,std::size_t,std::size_t) noexcept override {}
+		bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {return this==&other;}
+
+	private:
+		/**
+		 * \brief Block of memory requested from the system allocator
+		 */
+		struct Block {
+			char *data; 	//!< Start of the block
+			std::size_t size; 	//!< Size of the block in bytes
+		};
+
+		std::size_t _block_size; 	//!< Size of the regular blocks
+		std::vector<Block> _blocks; 	//!< Blocks owned by the arena, in the order in which they are used
+		std::size_t _current; 	//!< Index of the block following the one in use
+		char *_ptr; 	//!< Next free byte of the block in use
+		char *_end; 	//!< End of the block in use
+		std::size_t _used; 	//!< Number of bytes allocated since the last reset
+};
+
+#endif   /* ----- #ifndef ARENA_INC  ----- */
@@ -0,0 +1,796 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  benchmark.cpp
+ *
+ *    Description:  Micro-benchmarks of the keyword extraction components
+ *
+ *        Version:  1.0
+ *        Created:  17/10/2026 11:02:37
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  François Hissel
+ *   Organization:
+ *
+ * =====================================================================================
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cctype>
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <locale>
+#include <codecvt>
+#include <iterator>
+#include <string_view>
+#include <cmath>
+#include <tuple>
+#include <stdexcept>
+#include <atomic>
+#include <new>
+#include <cstdlib>
+#include <malloc.h>
+#include "format.h"
+#include "utf8.h"
+#include "tokenizer.h"
+#include "dictionary.h"
+#include "thread_pool.h"
+#include "kernel.h"
+#include "arena.h"
+#include "word_cache.h"
+#include "graph.h"
+#include "textrank.h"
+
+using namespace std;
+
+/*********************************************
+ *          Allocation counters              *
+ *********************************************/
+static atomic<uint64_t> allocations(0); 	//!< Number of calls to the global allocation functions since the start of the program
+static atomic<uint64_t> allocated(0); 	//!< Number of bytes requested from the global allocation functions since the start of the program
+
+/**
+ * \brief Global allocation function, which counts the allocations
+ *
+ * The array and non-throwing forms call this one.
+ * \param size Number of bytes
+ * \return Allocated memory
+ * \throw std::bad_alloc if the memory can not be allocated
+ */
+void *operator new(size_t size) {
+	allocations.fetch_add(1,memory_order_relaxed);
+	allocated.fetch_add(size,memory_order_relaxed);
+	if (void *res=malloc((size>0)?size:1)) return res;
+	throw bad_alloc();
+}
+
+void operator delete(void *p) noexcept {free(p);} 	//!< Global deallocation function, matching the counting allocation function
+void operator delete(void *p,size_t) noexcept {free(p);} 	//!< Global sized deallocation function, matching the counting allocation function
+
+/*********************************************
+ *           Utility functions               *
+ *********************************************/
+/**
+ * \brief Read a whole file in memory
+ *
+ * \param path Path name of the file
+ * \return Content of the file
+ */
+string read_file(const string &path) {
+	ifstream ifs(path,ifstream::binary);
+	ostringstream oss;
+	oss << ifs.rdbuf();
+	return oss.str();
+}
+
+/**
+ * \brief Split a UTF-8 text in words
+ *
+ * The split is coarse: ASCII characters which are not letters or digits are separators, all other bytes belong to words.
+ * \param text UTF-8 encoded text
+ * \return List of words
+ */
+vector<string> split_words(const string &text) {
+	vector<string> res;
+	string word;
+	for (char c:text) {
+		if ((unsigned char)(c)>=0x80 || isalnum((unsigned char)(c))) word.push_back(c);
+		else if (!word.empty()) {
+			res.push_back(word);
+			word.clear();
+		}
+	}
+	if (!word.empty()) res.push_back(word);
+	return res;
+}
+
+/**
+ * \brief Cut a text in documents made of whole sentences
+ *
+ * \param text Text
+ * \param words Smallest number of words of a document
+ * \return Documents, pointing into the text. The words at the end of the text which do not make a whole document are dropped
+ */
+vector<string_view> split_documents(const string &text,int words) {
+	// Sentences end at the same characters as in the tokenizer
+	vector<string_view> res;
+	size_t begin=0;
+	int count=0;
+	bool in_word=false;
+	for (size_t i=0;i<text.size();++i) {
+		bool space=isspace(static_cast<unsigned char>(text[i]));
+		if (!space && !in_word) ++count;
+		in_word=!space;
+		if ((text[i]=='.' || text[i]=='\n') && count>=words) {
+			res.push_back(string_view(text).substr(begin,i+1-begin));
+			begin=i+1;
+			count=0;
+		}
+	}
+	return res;
+}
+
+/**
+ * \brief Print the result of a benchmark
+ *
+ * \param name Name of the benchmark
+ * \param unit Unit of the measured value
+ * \param value Measured value
+ */
+void report(const string &name,const string &unit,double value) {
+	cout << name << '\t' << value << '\t' << unit << endl;
+}
+
+/**
+ * \brief Median of the durations of several runs of a function
+ *
+ * The median is less sensitive than the mean to the runs disturbed by other processes.
+ * \param repeat Number of runs
+ * \param fn Function to run
+ * \return Median duration of a run, in seconds
+ */
+template<class F> double median_time(int repeat,F fn) {
+	vector<double> times;
+	for (int r=0;r<repeat;++r) {
+		auto start=chrono::steady_clock::now();
+		fn();
+		times.push_back(chrono::duration<double>(chrono::steady_clock::now()-start).count());
+	}
+	nth_element(times.begin(),times.begin()+times.size()/2,times.end());
+	return times[times.size()/2];
+}
+
+/**
+ * \brief Read the results of a benchmark
+ *
+ * \param path Path name of the results, as printed by the benchmarks. Lines starting with '#' are comments
+ * \return Name, value and unit of each result, in the order of the file
+ */
+vector<tuple<string,double,string>> read_results(const string &path) {
+	ifstream ifs(path);
+	if (!ifs) throw runtime_error("Unable to open "+path);
+	vector<tuple<string,double,string>> res;
+	string line;
+	while (getline(ifs,line)) {
+		if (line.empty() || line[0]=='#') continue;
+		auto first=line.find('\t');
+		auto second=line.find('\t',first+1);
+		if (first==string::npos || second==string::npos) throw runtime_error("Invalid result in "+path+": "+line);
+		res.emplace_back(line.substr(0,first),stod(line.substr(first+1,second-first-1)),line.substr(second+1));
+	}
+	return res;
+}
+
+/*********************************************
+ *           Legacy tokenizer                *
+ *********************************************/
+/**
+ * \brief Facet used to tokenize a string, as done before the UTF-8 tokenizer
+ *
+ * The facet is derived from the standard character type facet but considers all punctuation signs as whitespaces.
+ */
+struct Tokenizer_facet:ctype<wchar_t> {
+
+	/**
+	 * \brief Classification of a character
+	 */
+	bool do_is(mask m,char_type c) const {
+		if ((m & space) && (!iswalnum(c) || c==L'-')) return true;
+		return ctype::do_is(m,c);
+	}
+};
+
+/**
+ * \brief Return a sentence from an input stream, as done before the UTF-8 tokenizer
+ *
+ * \param in Input stream
+ * \return Sentence read from the input stream
+ */
+wstring get_sentence(wistream &in) {
+	wostringstream oss;
+	wchar_t ch;
+	bool stop=false;
+	while (in && !stop) {
+		ch='\0';
+		in.get(ch);
+		if (in.fail() || in.bad() || ch==L'\n' || ch==L'.') {
+			stop=true;
+		} else oss.put(ch);
+	}
+	return oss.str();
+}
+
+/**
+ * \brief Split a text in words with the legacy tokenizer
+ *
+ * \param text UTF-8 encoded text
+ * \return Number of words
+ */
+size_t legacy_tokenize(const string &text) {
+	wistringstream ifs(from_utf8(text));
+	size_t res=0;
+	while (ifs) {
+		wstring sentence=get_sentence(ifs);
+		wistringstream iss(sentence);
+		iss.imbue(locale(iss.getloc(),new codecvt_utf8<wchar_t>));
+		iss.imbue(locale(iss.getloc(),new Tokenizer_facet));
+		vector<wstring> tokens;
+		copy(istream_iterator<wstring,wchar_t>(iss),istream_iterator<wstring,wchar_t>(),back_inserter(tokens));
+		res+=tokens.size();
+	}
+	return res;
+}
+
+/*********************************************
+ *               Benchmarks                  *
+ *********************************************/
+/**
+ * \brief Compare the UTF-8 tokenizer with the legacy stream-based tokenizer
+ *
+ * \param text Path name of a text file
+ * \param repeat Number of passes over the text
+ */
+void bench_tokenize(const string &text,int repeat) {
+	auto content=read_file(text);
+	size_t count=0;
+	auto start=chrono::steady_clock::now();
+	for (int r=0;r<repeat;++r) count=legacy_tokenize(content);
+	chrono::duration<double> elapsed=chrono::steady_clock::now()-start;
+	report("tokenize/legacy","tokens/s",double(count)*repeat/elapsed.count());
+	report("tokenize/legacy/tokens","tokens",count);
+	start=chrono::steady_clock::now();
+	for (int r=0;r<repeat;++r) {
+		Tokenizer tokenizer(content);
+		string_view word;
+		Token token;
+		count=0;
+		while ((token=tokenizer.next(word))!=Token::END) if (token==Token::WORD) ++count;
+	}
+	elapsed=chrono::steady_clock::now()-start;
+	report("tokenize/utf8","tokens/s",double(count)*repeat/elapsed.count());
+	report("tokenize/utf8/tokens","tokens",count);
+}
+
+/**
+ * \brief Compare the lookup engines of the dictionary
+ *
+ * \param dictionary Path name of the binary dictionary
+ * \param text Path name of a text file whose words are looked up
+ * \param repeat Number of passes over the words of the text
+ */
+void bench_lookup(const string &dictionary,const string &text,int repeat) {
+	auto words=split_words(read_file(text));
+	for (auto method:{Lookup::SEARCH,Lookup::HASH}) {
+		Dictionary dic(dictionary,method);
+		long found=0;
+		auto start=chrono::steady_clock::now();
+		for (int r=0;r<repeat;++r) for (const auto &w:words) if (dic.lookup(w)!=-1) ++found;
+		chrono::duration<double> elapsed=chrono::steady_clock::now()-start;
+		string name=(method==Lookup::SEARCH)?"lookup/search":"lookup/hash";
+		report(name,"tokens/s",double(words.size())*repeat/elapsed.count());
+		report(name+"/hits","tokens",double(found)/repeat);
+		// Case-insensitive lookup, either with two probes and a lower-case copy, or with one probe in the folded index
+		found=0;
+		start=chrono::steady_clock::now();
+		for (int r=0;r<repeat;++r) for (const auto &w:words) {
+			auto it=dic.lookup(w);
+			if (it==-1) {
+				string lower(w);
+				transform(lower.begin(),lower.end(),lower.begin(),fold_char);
+				it=dic.lookup(lower);
+			}
+			if (it!=-1) ++found;
+		}
+		elapsed=chrono::steady_clock::now()-start;
+		report(name+"/two_probes","tokens/s",double(words.size())*repeat/elapsed.count());
+		report(name+"/two_probes/hits","tokens",double(found)/repeat);
+		found=0;
+		start=chrono::steady_clock::now();
+		for (int r=0;r<repeat;++r) for (const auto &w:words) if (dic.lookup_folded(w)!=-1) ++found;
+		elapsed=chrono::steady_clock::now()-start;
+		report(name+"/folded","tokens/s",double(words.size())*repeat/elapsed.count());
+		report(name+"/folded/hits","tokens",double(found)/repeat);
+	}
+}
+
+/**
+ * \brief Measure the scaling of the TextRank iterations with the number of threads
+ *
+ * The scores computed with each number of threads are also compared with the scores computed by a single thread, which must be identical. The assembly of the multi-word keywords is then timed by ranking all the nodes of the graph.
+ * \param dictionary Path name of the binary dictionary
+ * \param text Path name of the text whose graph is ranked
+ * \param repeat Number of runs of the algorithm for each number of threads
+ * \param max_threads Largest number of threads
+ */
+void bench_rank(const string &dictionary,const string &text,int repeat,int max_threads) {
+	Dictionary dic(dictionary);
+	Graph graph(read_file(text),dic,3);
+	report("rank/nodes","nodes",graph.size());
+	vector<double> reference;
+	double single=0.0;
+	for (int threads=1;threads<=max_threads;++threads) {
+		unique_ptr<Thread_pool> pool;
+		Rank_parameters parameters;
+		if (threads>1) {
+			pool=make_unique<Thread_pool>(threads-1);
+			parameters.pool=pool.get();
+		}
+		int iterations=0;
+		auto start=chrono::steady_clock::now();
+		for (int r=0;r<repeat;++r) iterations+=graph.text_rank(parameters).iterations;
+		chrono::duration<double> elapsed=chrono::steady_clock::now()-start;
+		string name="rank/threads_"+to_string(threads);
+		report(name,"iterations/s",iterations/elapsed.count());
+		if (threads==1) single=elapsed.count();
+		else report(name+"/speedup","x",single/elapsed.count());
+		vector<double> scores(graph.size());
+		for (int32_t i=0;i<graph.size();++i) scores[i]=graph.score(i);
+		if (threads==1) reference=scores;
+		else report(name+"/identical","bool",scores==reference);
+	}
+	// All the nodes are keywords, so that the assembly of the multi-word keywords dominates the ranking
+	Rank_parameters parameters;
+	parameters.num_keywords=graph.size();
+	parameters.max_iterations=1;
+	size_t keywords=0;
+	auto start=chrono::steady_clock::now();
+	for (int r=0;r<repeat;++r) keywords=graph.text_rank(parameters).size();
+	chrono::duration<double> elapsed=chrono::steady_clock::now()-start;
+	report("rank/phrases","rankings/s",repeat/elapsed.count());
+	report("rank/phrases/keywords","keywords",keywords);
+}
+
+/**
+ * \brief Compare the kernels of the TextRank iterations
+ *
+ * Each combination of instruction set and precision is timed, and its scores are compared with the scores of the scalar 64-bit kernel.
+ * \param dictionary Path name of the binary dictionary
+ * \param text Path name of the text whose graph is ranked
+ * \param repeat Number of runs of the algorithm for each kernel
+ */
+void bench_kernel(const string &dictionary,const string &text,int repeat) {
+	Dictionary dic(dictionary);
+	Graph graph(read_file(text),dic,3);
+	vector<double> reference;
+	for (auto precision:{Precision::DOUBLE,Precision::FLOAT}) for (auto kernel:{Kernel::SCALAR,Kernel::AVX2,Kernel::AVX512}) {
+		Rank_parameters parameters;
+		parameters.precision=precision;
+		parameters.kernel=kernel;
+		int iterations=0;
+		auto start=chrono::steady_clock::now();
+		for (int r=0;r<repeat;++r) iterations+=graph.text_rank(parameters).iterations;
+		chrono::duration<double> elapsed=chrono::steady_clock::now()-start;
+		string name=string("kernel/")+kernel_name(kernel)+((precision==Precision::DOUBLE)?"/double":"/float");
+		report(name,"iterations/s",iterations/elapsed.count());
+		double error=0.0;
+		for (int32_t i=0;i<graph.size();++i) {
+			if (reference.size()<size_t(graph.size())) reference.push_back(graph.score(i));
+			error=max(error,fabs(graph.score(i)-reference[i])/reference[i]);
+		}
+		report(name+"/relative_error","ratio",error);
+	}
+	report(string("kernel/best_")+kernel_name(best_kernel()),"bool",1);
+}
+
+/**
+ * \brief Compare the solvers of the TextRank equations
+ *
+ * Each solver runs until the residual is lower than 1e-6, and reports its time, its number of iterations and the number of edges it read. Its scores are compared with the scores of the Jacobi solver run until the residual is lower than 1e-12: the share of the keywords of the reference found in its keywords, and the largest relative difference of the scores.
+ * \param dictionary Path name of the binary dictionary
+ * \param text Path name of the text whose graph is ranked
+ * \param repeat Number of runs of each solver
+ */
+void bench_solver(const string &dictionary,const string &text,int repeat) {
+	Dictionary dic(dictionary);
+	Graph graph(read_file(text),dic,3);
+	Rank_parameters parameters;
+	parameters.max_iterations=10000;
+	parameters.tolerance=1e-12;
+	auto keywords=graph.text_rank(parameters);
+	vector<double> reference;
+	for (int32_t i=0;i<graph.size();++i) reference.push_back(graph.score(i));
+	parameters.max_iterations=1000;
+	parameters.tolerance=1e-6;
+	for (auto solver:{Solver::JACOBI,Solver::GAUSS_SEIDEL,Solver::AITKEN,Solver::PUSH}) {
+		parameters.solver=solver;
+		Ranking res;
+		auto time=median_time(repeat,[&]() {res=graph.text_rank(parameters);});
+		string name=string("solver/")+solver_name(solver);
+		report(name,"ms",time*1e3);
+		report(name+"/iterations","iterations",res.iterations);
+		report(name+"/traversals","edges",res.traversals);
+		size_t found=0;
+		for (const auto &it:keywords) found+=(find_if(res.begin(),res.end(),[&it](const auto &a){return a.first==it.first;})!=res.end());
+		report(name+"/keywords","%",keywords.empty()?100.0:100.0*found/keywords.size());
+		double error=0.0;
+		for (int32_t i=0;i<graph.size();++i) error=max(error,fabs(graph.score(i)-reference[i])/reference[i]);
+		report(name+"/relative_error","ratio",error);
+	}
+}
+
+/**
+ * \brief Compare the ranking of many small documents one by one and in batches
+ *
+ * The text is cut in documents made of whole sentences and of at least a given number of words, such as short messages or titles. The graphs of all the documents are built and ranked once, then ranked again one by one with text_rank and at once with text_rank_batch, either with 20 iterations or until the residual is lower than 1e-6. The keywords, iterations and residuals of both must be identical. The whole extraction, from the text of the documents to their keywords, is also timed one document at a time and by batches of 64 documents, with an arena and a cache of the words shared by all the graphs as in the batch mode of the program.
+ * \param dictionary Path name of the binary dictionary
+ * \param text Path name of the text
+ * \param repeat Number of runs of each benchmark
+ * \param words Smallest number of words of a document
+ */
+void bench_batch(const string &dictionary,const string &text,int repeat,int words) {
+	const size_t batch=64;
+	Dictionary dic(dictionary);
+	auto content=read_file(text);
+	auto documents=split_documents(content,words);
+	report("batch/documents","documents",documents.size());
+	vector<unique_ptr<Graph>> graphs;
+	vector<Graph*> pointers;
+	for (auto doc:documents) {
+		graphs.push_back(make_unique<Graph>(doc,dic,3));
+		pointers.push_back(graphs.back().get());
+	}
+	Rank_parameters converged;
+	converged.max_iterations=100;
+	converged.tolerance=1e-6;
+	for (const auto &[mode,parameters]:{make_pair("fixed",Rank_parameters()),make_pair("converged",converged)}) {
+		vector<Rank_parameters> all(graphs.size(),parameters);
+		vector<Ranking> single;
+		for (auto &graph:graphs) single.push_back(graph->text_rank(parameters));
+		auto time=median_time(repeat,[&]() {for (auto &graph:graphs) graph->text_rank(parameters);});
+		string name=string("batch/rank_")+mode;
+		report(name+"/one_by_one","documents/s",graphs.size()/time);
+		vector<Ranking> batched;
+		time=median_time(repeat,[&]() {batched=Graph::text_rank_batch(pointers,all);});
+		report(name+"/batched","documents/s",graphs.size()/time);
+		bool identical=true;
+		for (size_t i=0;i<graphs.size();++i) identical=identical && batched[i]==single[i] && batched[i].iterations==single[i].iterations && batched[i].residual==single[i].residual && batched[i].traversals==single[i].traversals;
+		report(name+"/identical","bool",identical);
+	}
+	Arena arena;
+	Word_cache cache;
+	auto time=median_time(repeat,[&]() {
+		for (auto doc:documents) {
+			{
+				Graph graph(doc,dic,3,&arena,nullptr,&cache);
+				graph.text_rank(Rank_parameters());
+			}
+			arena.reset();
+		}
+	});
+	report("batch/extract/one_by_one","documents/s",documents.size()/time);
+	time=median_time(repeat,[&]() {
+		for (size_t first=0;first<documents.size();first+=batch) {
+			auto last=min(documents.size(),first+batch);
+			vector<unique_ptr<Graph>> graphs;
+			vector<Graph*> pointers;
+			for (auto i=first;i<last;++i) {
+				graphs.push_back(make_unique<Graph>(documents[i],dic,3,&arena,nullptr,&cache));
+				pointers.push_back(graphs.back().get());
+			}
+			Graph::text_rank_batch(pointers,vector<Rank_parameters>(pointers.size()));
+			graphs.clear();
+			arena.reset();
+		}
+	});
+	report("batch/extract/batched","documents/s",documents.size()/time);
+}
+
+/**
+ * \brief Measure the extraction of the keywords of many small documents through the C interface of the library
+ *
+ * The text is cut in documents as in the batch benchmark. Their keywords are extracted with a single extractor, whose memory and cache of the words are reused from one document to the next, either into the memory of the extractor or into memory given by the caller, and with a new extractor for each document. The same extraction with the Graph class shows the cost of the interface itself.
+ * \param dictionary Path name of the binary dictionary
+ * \param text Path name of the text
+ * \param repeat Number of runs of each benchmark
+ * \param words Smallest number of words of a document
+ */
+void bench_api(const string &dictionary,const string &text,int repeat,int words) {
+	auto content=read_file(text);
+	auto documents=split_documents(content,words);
+	report("api/documents","documents",documents.size());
+	textrank_dictionary *dic=nullptr;
+	if (textrank_dictionary_open(dictionary.c_str(),TEXTRANK_LOOKUP_AUTO,&dic)!=TEXTRANK_OK) throw runtime_error(textrank_last_error());
+	unique_ptr<textrank_dictionary,void(*)(textrank_dictionary*)> dic_owner(dic,textrank_dictionary_close);
+	textrank_extractor *extractor=nullptr;
+	if (textrank_extractor_create(dic,1,&extractor)!=TEXTRANK_OK) throw runtime_error(textrank_last_error());
+	unique_ptr<textrank_extractor,void(*)(textrank_extractor*)> extractor_owner(extractor,textrank_extractor_destroy);
+	textrank_result res;
+	auto time=median_time(repeat,[&]() {
+		for (auto doc:documents) textrank_extract(extractor,doc.data(),doc.size(),nullptr,&res);
+	});
+	report("api/extract","documents/s",documents.size()/time);
+	vector<textrank_keyword> keywords(Rank_parameters().num_keywords);
+	vector<char> buffer(4096);
+	time=median_time(repeat,[&]() {
+		for (auto doc:documents) textrank_extract_to(extractor,doc.data(),doc.size(),nullptr,keywords.data(),keywords.size(),buffer.data(),buffer.size(),&res);
+	});
+	report("api/extract_to","documents/s",documents.size()/time);
+	time=median_time(repeat,[&]() {
+		for (auto doc:documents) {
+			textrank_extractor *single=nullptr;
+			textrank_extractor_create(dic,1,&single);
+			textrank_extract(single,doc.data(),doc.size(),nullptr,&res);
+			textrank_extractor_destroy(single);
+		}
+	});
+	report("api/new_extractor","documents/s",documents.size()/time);
+	Dictionary direct(dictionary);
+	Arena arena;
+	Word_cache cache;
+	time=median_time(repeat,[&]() {
+		for (auto doc:documents) {
+			{
+				Graph graph(doc,direct,3,&arena,nullptr,&cache);
+				graph.text_rank(Rank_parameters());
+			}
+			arena.reset();
+		}
+	});
+	report("api/graph","documents/s",documents.size()/time);
+}
+
+/**
+ * \brief Measure the construction of the graph
+ *
+ * The memory held by a graph is measured as the growth of the heap while it is alive. The graph is then built several times with its own arena, and with a single arena reset between the constructions. The number of calls to the allocator and the number of bytes requested by one construction are counted.
+ * \param dictionary Path name of the binary dictionary
+ * \param text Path name of the text whose graph is built
+ * \param repeat Number of constructions of the graph
+ */
+void bench_graph(const string &dictionary,const string &text,int repeat) {
+	Dictionary dic(dictionary);
+	auto content=read_file(text);
+	size_t words=0;
+	Tokenizer tokenizer(content);
+	string_view word;
+	for (Token token;(token=tokenizer.next(word))!=Token::END;) if (token==Token::WORD) ++words;
+	report("graph/words","words",words);
+	auto before=mallinfo2().uordblks;
+	{
+		Graph graph(content,dic,3);
+		auto after=mallinfo2().uordblks;
+		report("graph/nodes","nodes",graph.size());
+		report("graph/heap","bytes/word",double(after-before)/words);
+	}
+	auto start=chrono::steady_clock::now();
+	for (int r=0;r<repeat;++r) Graph graph(content,dic,3);
+	chrono::duration<double> elapsed=chrono::steady_clock::now()-start;
+	report("graph/build","words/s",double(words)*repeat/elapsed.count());
+	auto count=allocations.load();
+	auto bytes=allocated.load();
+	{
+		Graph graph(content,dic,3);
+	}
+	report("graph/allocations","allocations",allocations.load()-count);
+	report("graph/allocated","bytes",allocated.load()-bytes);
+	Arena arena;
+	start=chrono::steady_clock::now();
+	for (int r=0;r<repeat;++r) {
+		{
+			Graph graph(content,dic,3,&arena);
+		}
+		arena.reset();
+	}
+	elapsed=chrono::steady_clock::now()-start;
+	report("graph/build_reused_arena","words/s",double(words)*repeat/elapsed.count());
+}
+
+/**
+ * \brief Measure the update of the keywords of a sliding window of sentences
+ *
+ * The text is fed sentence by sentence to a graph restricted to its last 1000 sentences, and the keywords are ranked every few sentences, starting the iterations either from 1 or from the previous scores. The same updates are also done by building the graph of the window from scratch each time. The iterations stop when the residual is lower than 1e-6.
+ * \param dictionary Path name of the binary dictionary
+ * \param text Path name of the text
+ * \param step Number of sentences between two updates
+ */
+void bench_window(const string &dictionary,const string &text,int step) {
+	const size_t window=1000;
+	Dictionary dic(dictionary);
+	auto content=read_file(text);
+	// Sentences end at the same characters as in the tokenizer
+	vector<size_t> ends;
+	for (size_t i=0;i<content.size();++i) if (content[i]=='.' || content[i]=='\n') ends.push_back(i+1);
+	if (ends.empty() || ends.back()!=content.size()) ends.push_back(content.size());
+	Rank_parameters parameters;
+	parameters.max_iterations=100;
+	parameters.tolerance=1e-6;
+	for (auto mode:{"cold","warm","rebuild"}) {
+		parameters.warm_start=(string(mode)=="warm");
+		size_t updates=0;
+		long iterations=0;
+		auto start=chrono::steady_clock::now();
+		if (string(mode)=="rebuild") {
+			for (size_t i=step;i<=ends.size();i+=step) {
+				auto first=(i>window)?ends[i-window-1]:0;
+				Graph graph(string_view(content).substr(first,ends[i-1]-first),dic,3);
+				iterations+=graph.text_rank(parameters).iterations;
+				++updates;
+			}
+		} else {
+			Graph graph(dic,3,window);
+			size_t begin=0;
+			for (size_t i=0;i<ends.size();++i) {
+				graph.append(string_view(content).substr(begin,ends[i]-begin));
+				begin=ends[i];
+				if ((i+1)%step==0) {
+					iterations+=graph.text_rank(parameters).iterations;
+					++updates;
+				}
+			}
+		}
+		chrono::duration<double> elapsed=chrono::steady_clock::now()-start;
+		string name=string("window/")+mode;
+		report(name,"updates/s",updates/elapsed.count());
+		report(name+"/iterations","iterations/update",double(iterations)/updates);
+	}
+}
+
+/**
+ * \brief Run the reference suite of benchmarks
+ *
+ * The suite measures each component on its own (loading of the dictionary, lookup with and without the cache of the words, tokenization, construction of the graph, iterations) and the whole extraction, on the first 5000 words of the text, which are about 10 pages, and on the whole text. Each result is the median of several runs. The results are printed one per line, in a fixed order, so that the results of two versions may be compared with the 'compare' command or with diff.
+ * \param dictionary Path name of the binary dictionary
+ * \param text Path name of the text
+ * \param repeat Number of runs of each benchmark
+ */
+void bench_suite(const string &dictionary,const string &text,int repeat) {
+	auto content=read_file(text);
+	auto words=split_words(content);
+	size_t tokens=0;
+	size_t page=content.size();
+	{
+		Tokenizer tokenizer(content);
+		string_view word;
+		for (Token token;(token=tokenizer.next(word))!=Token::END;) {
+			if (token==Token::WORD) ++tokens;
+			else if (tokens>=5000 && page==content.size()) page=word.data()+word.size()-content.data();
+		}
+	}
+	string_view pages(content.data(),page);
+	Dictionary dic(dictionary);
+	cout << "# dictionary\t" << dic.size() << "\tentries\n# text\t" << tokens << "\twords\n# pages\t" << pages.size() << "\tbytes\n";
+	auto time=median_time(repeat,[&]() {Dictionary loaded(dictionary);});
+	report("suite/load","ms",time*1e3);
+	long found=0;
+	time=median_time(repeat,[&]() {for (const auto &w:words) found+=(dic.lookup(w)!=-1);});
+	report("suite/lookup","tokens/s",words.size()/time);
+	report("suite/lookup/hits","tokens",double(found)/repeat);
+	found=0;
+	time=median_time(repeat,[&]() {for (const auto &w:words) found+=(dic.lookup_folded(w)!=-1);});
+	report("suite/lookup_folded","tokens/s",words.size()/time);
+	report("suite/lookup_folded/hits","tokens",double(found)/repeat);
+	Word_cache cache;
+	found=0;
+	time=median_time(repeat,[&]() {for (const auto &w:words) found+=(cache.lookup(w,dic).entry!=-1);});
+	report("suite/lookup_cached","tokens/s",words.size()/time);
+	report("suite/lookup_cached/hits","tokens",double(found)/repeat);
+	report("suite/lookup_cached/hit_rate","%",100.0*cache.hits()/(cache.hits()+cache.misses()));
+	time=median_time(repeat,[&]() {
+		Tokenizer tokenizer(content);
+		string_view word;
+		while (tokenizer.next(word)!=Token::END);
+	});
+	report("suite/tokenize","tokens/s",tokens/time);
+	time=median_time(repeat,[&]() {Graph graph(content,dic,3);});
+	report("suite/graph","words/s",tokens/time);
+	auto count=allocations.load();
+	{
+		Graph graph(content,dic,3);
+	}
+	report("suite/graph/allocations","allocations",allocations.load()-count);
+	Graph graph(content,dic,3);
+	Rank_parameters parameters;
+	time=median_time(repeat,[&]() {graph.text_rank(parameters);});
+	report("suite/rank","ms",time*1e3);
+	report("suite/rank/nodes","nodes",graph.size());
+	// The whole extraction, as done by the program, including the loading of the dictionary
+	time=median_time(repeat,[&]() {
+		Dictionary loaded(dictionary);
+		Graph graph(pages,loaded,3);
+		graph.text_rank(parameters);
+	});
+	report("suite/extract_10_pages","ms",time*1e3);
+	time=median_time(repeat,[&]() {
+		Graph graph(content,dic,3);
+		graph.text_rank(parameters);
+	});
+	report("suite/extract_text","ms",time*1e3);
+}
+
+/**
+ * \brief Compare two results of the benchmarks
+ *
+ * The results of both files are matched by name, and the ratio of the new value to the old one is printed for each of them.
+ * \param before Path name of the old results
+ * \param after Path name of the new results
+ */
+void compare(const string &before,const string &after) {
+	auto old_results=read_results(before);
+	auto new_results=read_results(after);
+	for (const auto &[name,value,unit]:new_results) {
+		auto it=find_if(old_results.begin(),old_results.end(),[&name](const auto &a){return get<0>(a)==name;});
+		if (it==old_results.end()) cout << name << "\t-\t" << value << '\t' << unit << "\tnew\n";
+		else cout << name << '\t' << get<1>(*it) << '\t' << value << '\t' << unit << '\t' << ((get<1>(*it)!=0)?value/get<1>(*it):0.0) << "x\n";
+	}
+}
+
+/**
+ * \brief Main program
+ *
+ * \param argc Number of command-line arguments, including the name of the program
+ * \param argv Array or command-line arguments, the first element is the name of the program
+ * \return 0 if the execution was successful, an error code otherwise
+ */
+int main(int argc,char *argv[]) {
+	if (argc>2 && string(argv[1])=="tokenize") {
+		locale::global(locale(""));
+		bench_tokenize(argv[2],(argc>3)?stoi(argv[3]):10);
+		return 0;
+	}
+	if (argc==4 && string(argv[1])=="compare") {
+		try {
+			compare(argv[2],argv[3]);
+		} catch (const exception &e) {
+			cerr << e.what() << '\n';
+			return 1;
+		}
+		return 0;
+	}
+	if (argc<4) {
+		cerr << "Syntax: benchmark lookup|rank|kernel|solver|graph path_to_dictionary path_to_text [repeat] [max_threads]\n"
+			"       benchmark window path_to_dictionary path_to_text [step]\n"
+			"       benchmark batch|api path_to_dictionary path_to_text [repeat] [words]\n"
+			"       benchmark suite path_to_dictionary path_to_text [repeat]\n"
+			"       benchmark compare path_to_old_results path_to_new_results\n"
+			"       benchmark tokenize path_to_text [repeat]\n";
+		return 1;
+	}
+	string command=argv[1];
+	int repeat=(argc>4)?stoi(argv[4]):10;
+	int max_threads=(argc>5)?stoi(argv[5]):max(1u,thread::hardware_concurrency());
+	try {
+		if (command=="lookup") bench_lookup(argv[2],argv[3],repeat);
+		else if (command=="rank") bench_rank(argv[2],argv[3],repeat,max_threads);
+		else if (command=="kernel") bench_kernel(argv[2],argv[3],repeat);
+		else if (command=="solver") bench_solver(argv[2],argv[3],max(1,repeat));
+		else if (command=="graph") bench_graph(argv[2],argv[3],repeat);
+		else if (command=="batch") bench_batch(argv[2],argv[3],max(1,repeat),(argc>5)?stoi(argv[5]):30);
+		else if (command=="api") bench_api(argv[2],argv[3],max(1,repeat),(argc>5)?stoi(argv[5]):30);
+		else if (command=="window") bench_window(argv[2],argv[3],max(1,repeat));
+		else if (command=="suite") bench_suite(argv[2],argv[3],max(1,repeat));
+		else {
+			cerr << "Unknown benchmark " << command << '\n';
+			return 1;
+		}
+	} catch (const exception &e) {
+		cerr << e.what() << '\n';
+		return 1;
+	}
+}
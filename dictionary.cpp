@@ -17,34 +17,29 @@
  */
 
 #include <iostream>
-#include <vector>
-#include <map>
 #include <string>
-#include <locale>
-#include <codecvt>
-#include <fstream>
-#include <utility>
-#include <filesystem>
+#include <string_view>
+#include <cstring>
+#include <cstddef>
 #include <limits>
+#include <cerrno>
+#include <stdexcept>
+#include <algorithm>
+#include <atomic>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "format.h"
 #include "dictionary.h"
 
 using namespace std;
 
-/*********************************************
- *           Utility functions               *
- *********************************************/
-wstring next_token(const wstring &s,wstring::size_type &pos) {
-	auto i=pos;
-	pos=s.find_first_of(L'\t',i);
-	if (pos==wstring::npos) pos=s.length();
-	return s.substr(i,(pos++)-i);
-}
-
 /*********************************************
  *                 Entry                     *
  *********************************************/
-void Entry::print(wostream &out) const {
-	out << word << L"\t(" ;
+void Entry::print(ostream &out) const {
+	out << word << "\t(" ;
 	switch (pos) {
 		case Pos::ADJ: out << "ADJ"; break;
 		case Pos::ADV: out << "ADV"; break;
@@ -56,62 +51,195 @@ void Entry::print(wostream &out) const {
 	out << "," << lemma << ")";
 }
 
+/*********************************************
+ *           Utility functions               *
+ *********************************************/
+/**
+ * \brief Compare the case-folded versions of two words
+ *
+ * \param a First word, which is folded on the fly
+ * \param b Second word, which is folded on the fly
+ * \return Negative value, zero or positive value if the folded version of a is respectively lower, equal or greater than the folded version of b
+ */
+int compare_folded(string_view a,string_view b) noexcept {
+	auto n=min(a.size(),b.size());
+	string_view::size_type i=0;
+	// The common prefix is skipped eight bytes at a time, and the first block which differs is compared byte by byte
+	for (;i+8<=n;i+=8) {
+		uint64_t x,y;
+		memcpy(&x,a.data()+i,8);
+		memcpy(&y,b.data()+i,8);
+		if (fold_block(x)!=fold_block(y)) break;
+	}
+	for (;i<n;++i) {
+		auto ca=(unsigned char)(fold_char(a[i]));
+		auto cb=(unsigned char)(fold_char(b[i]));
+		if (ca!=cb) return (ca<cb)?-1:1;
+	}
+	return (a.size()<b.size())?-1:((a.size()>b.size())?1:0);
+}
+
+/**
+ * \brief Check the checksum and the content of a section of the dictionary file
+ *
+ * The elements of each block are checked just after the checksum of the block, while the block is still in the cache, so that the section is read only once.
+ * \param data Start of the section
+ * \param size Size of the section, in bytes
+ * \param expected Checksum stored in the header
+ * \param width Size of the elements of the section, in bytes, which must divide CHECKSUM_BLOCK
+ * \param check Function called with the index of each element, which returns false if the element is not valid
+ * \return True if the checksum is right and all the elements are valid
+ */
+template<class Check> bool check_section(const char *data,size_t size,uint64_t expected,size_t width,Check check) {
+	uint64_t sum=0;
+	for (size_t i=0;i<size;i+=CHECKSUM_BLOCK) {
+		auto n=min(CHECKSUM_BLOCK,size-i);
+		sum=checksum_block(data+i,n,sum);
+		for (size_t j=i/width;j<(i+n)/width;++j) if (!check(j)) return false;
+	}
+	return sum==expected;
+}
+
 /*********************************************
  *               Dictionary                  *
  *********************************************/
-void Dictionary::print(wostream &out) const {
-	for (const auto &it:*this) out << it << endl;
+void Dictionary::print(ostream &out) const {
+	for (int32_t i=0;i<size();++i) out << (*this)[i] << endl;
 }
 
-//Dictionary::Dictionary(const string &path) {
-//	locale loc("");
-//	wifstream ifs(path);
-//	reserve(std::filesystem::file_size(path)/15);
-//	ifs.imbue(locale(ifs.getloc(),new codecvt_utf8<wchar_t>));
-//	wstring word,pos,lemma;
-//	wstring line;
-//	while (ifs) {
-//		getline(ifs,line);
-//		if (ifs.fail() || ifs.bad()) continue;
-//		string::size_type i=0;
-//		word=next_token(line,i);
-//		pos=next_token(line,i);
-//		lemma=next_token(line,i);
-//		Pos p;
-//		if (pos==L"N") p=Pos::NOUN;
-//		else if (pos==L"A") p=Pos::ADJ;
-//		else if (pos==L"") p=Pos::UNKNOWN;
-//		else p=Pos::STOP;
-//		push_back(Entry(word,p,lemma));
-//	}
-//}
+Dictionary::Dictionary(const string &path,Lookup method) {
+	int fd=open(path.c_str(),O_RDONLY);
+	if (fd<0) throw runtime_error("Unable to open dictionary "+path+": "+strerror(errno));
+	struct stat st;
+	if (fstat(fd,&st)<0) {
+		close(fd);
+		throw runtime_error("Unable to read dictionary "+path+": "+strerror(errno));
+	}
+	_length=st.st_size;
+	if (_length<sizeof(Dictionary_header)) {
+		close(fd);
+		throw runtime_error("Invalid dictionary "+path+": file is too short");
+	}
+	void *data=mmap(nullptr,_length,PROT_READ,MAP_SHARED,fd,0);
+	close(fd);
+	if (data==MAP_FAILED) throw runtime_error("Unable to map dictionary "+path+": "+strerror(errno));
+	_data=static_cast<const char*>(data);
+	auto fail=[&](const string &reason) {
+		munmap(data,_length);
+		throw runtime_error("Invalid dictionary "+path+": "+reason);
+	};
+	const auto *header=reinterpret_cast<const Dictionary_header*>(_data);
+	if (memcmp(header->magic,DICTIONARY_MAGIC,sizeof(DICTIONARY_MAGIC))!=0 || little_endian(header->version)!=DICTIONARY_VERSION) fail("unknown format, generate it again with 'prepare'");
+	if (little_endian(header->checksum)!=checksum(_data,offsetof(Dictionary_header,checksum))) fail("corrupt header");
+	_count=little_endian(header->count);
+	_buckets=little_endian(header->hash_buckets);
+	_groups=little_endian(header->groups);
+	_fold_buckets=little_endian(header->fold_buckets);
+	auto pool_size=little_endian(header->pool_size);
+	if (_count>uint32_t(numeric_limits<int32_t>::max()) || _groups>_count || (_buckets>0 && _count==0) || (_fold_buckets>0 && _groups==0)) fail("corrupt header");
+	// Each section must have the size given by the counts of the header, and the sections must follow each other without overlapping
+	const uint64_t sizes[SECTIONS]={(uint64_t(_count)+1)*sizeof(uint32_t),uint64_t(_count)*sizeof(int32_t),tags_size(_count),uint64_t(_buckets)*sizeof(uint32_t),(_buckets>0)?uint64_t(_count)*sizeof(Hash_slot):0,uint64_t(_count)*sizeof(uint32_t),(uint64_t(_groups)+1)*sizeof(uint32_t),uint64_t(_groups)*sizeof(int32_t),uint64_t(_fold_buckets)*sizeof(uint32_t),(_fold_buckets>0)?uint64_t(_groups)*sizeof(Hash_slot):0,pool_size};
+	const char *sections[SECTIONS];
+	uint64_t end=sizeof(Dictionary_header);
+	for (int i=0;i<SECTIONS;++i) {
+		auto offset=little_endian(header->sections[i].offset);
+		auto size=little_endian(header->sections[i].size);
+		if (size!=sizes[i] || offset%SECTION_ALIGNMENT!=0 || offset<end || offset>_length || size>_length-offset) fail("corrupt section table");
+		sections[i]=_data+offset;
+		end=offset+size;
+	}
+	if (end!=_length) fail("unexpected file size");
+	_offsets=reinterpret_cast<const uint32_t*>(sections[int(Section::OFFSETS)]);
+	_lemmas=reinterpret_cast<const int32_t*>(sections[int(Section::LEMMAS)]);
+	_tags=sections[int(Section::TAGS)];
+	_displacements=reinterpret_cast<const uint32_t*>(sections[int(Section::DISPLACEMENTS)]);
+	_slots=reinterpret_cast<const Hash_slot*>(sections[int(Section::SLOTS)]);
+	_fold_order=reinterpret_cast<const uint32_t*>(sections[int(Section::FOLD_ORDER)]);
+	_fold_groups=reinterpret_cast<const uint32_t*>(sections[int(Section::FOLD_GROUPS)]);
+	_fold_lower=reinterpret_cast<const int32_t*>(sections[int(Section::FOLD_LOWER)]);
+	_fold_displacements=reinterpret_cast<const uint32_t*>(sections[int(Section::FOLD_DISPLACEMENTS)]);
+	_fold_slots=reinterpret_cast<const Hash_slot*>(sections[int(Section::FOLD_SLOTS)]);
+	_pool=sections[int(Section::POOL)];
+	// Checksums and content of the sections, so that no index read from the file may point outside of it
+	auto valid=[&](Section section,size_t width,auto check) {return check_section(sections[int(section)],sizes[int(section)],little_endian(header->sections[int(section)].checksum),width,check);};
+	auto entry=[this](int32_t v) {return v==-1 || (v>=0 && uint32_t(v)<_count);};
+	auto any=[](size_t) {return true;};
+	if (!valid(Section::OFFSETS,sizeof(uint32_t),[&](size_t j) {auto v=little_endian(_offsets[j]);return (j==0)?v==0:(v>=little_endian(_offsets[j-1]) && (j<_count || v==pool_size));})
+		|| !valid(Section::LEMMAS,sizeof(int32_t),[&](size_t j) {return entry(little_endian(_lemmas[j]));})
+		|| !valid(Section::TAGS,1,any)
+		|| !valid(Section::DISPLACEMENTS,sizeof(uint32_t),any)
+		|| !valid(Section::SLOTS,sizeof(Hash_slot),[&](size_t j) {return little_endian(_slots[j].entry)<_count;})
+		|| !valid(Section::FOLD_ORDER,sizeof(uint32_t),[&](size_t j) {return little_endian(_fold_order[j])<_count;})
+		|| !valid(Section::FOLD_GROUPS,sizeof(uint32_t),[&](size_t j) {auto v=little_endian(_fold_groups[j]);return (j==0)?v==0:(v>=little_endian(_fold_groups[j-1]) && (j<_groups || v==_count));})
+		|| !valid(Section::FOLD_LOWER,sizeof(int32_t),[&](size_t j) {return entry(little_endian(_fold_lower[j]));})
+		|| !valid(Section::FOLD_DISPLACEMENTS,sizeof(uint32_t),any)
+		|| !valid(Section::FOLD_SLOTS,sizeof(Hash_slot),[&](size_t j) {return little_endian(_fold_slots[j].entry)<_groups;})
+		|| !valid(Section::POOL,1,any)) fail("corrupt file");
+	if (method==Lookup::AUTO) method=(_buckets>0)?Lookup::HASH:Lookup::SEARCH;
+	if (method==Lookup::HASH && (_buckets==0 || _fold_buckets==0)) {
+		munmap(data,_length);
+		throw runtime_error("Invalid dictionary "+path+": no hash table, generate it again with 'prepare'");
+	}
+	_method=method;
+	static atomic<uint64_t> last_id(0);
+	_id=++last_id;
+}
+
+Dictionary::~Dictionary() {
+	munmap(const_cast<char*>(_data),_length);
+}
 
-Dictionary::Dictionary(const string &path) {
-	ifstream ifs(path,ifstream::binary);
-	reserve(std::filesystem::file_size(path)/17);
-	wstring_convert<codecvt_utf8<wchar_t>> converter;
-	while (ifs) {
-		char a;
-		ifs.read(&a,1);
-		if (ifs.fail() || ifs.bad()) continue;
-		Pos p;
-		switch (a) {
-			case 'N':p=Pos::NOUN;break;
-			case 'A':p=Pos::ADJ;break;
-			case 'S':p=Pos::STOP;break;
-			default:p=Pos::UNKNOWN;break;
-		}
-		int32_t ilemma;
-		ifs.read((char*)(&ilemma),sizeof(int32_t));
-		unsigned char len;
-		ifs.read((char*)(&len),sizeof(unsigned char));
-		char res[len+1];
-		ifs.read(res,len);
-		res[len]=0;
-		wstring word=converter.from_bytes(res);
-		push_back(Entry(word,p,L"",ilemma));
+int32_t Dictionary::lookup_search(string_view w) const noexcept {
+	uint32_t first=0,count=_count;
+	while (count>0) {
+		uint32_t step=count/2;
+		uint32_t it=first+step;
+		if (word(it)<w) {
+			first=it+1;
+			count-=step+1;
+		} else count=step;
 	}
-	for (auto &it:(*this)) {
-		if (it.ilemma==-1) it.lemma=it.word; else it.lemma=at(it.ilemma).word;
+	if (first<_count && word(first)==w) return first;
+	return -1;
+}
+
+int32_t Dictionary::lookup_hash(string_view w,uint64_t h) const noexcept {
+	const auto &slot=_slots[hash_position(h,little_endian(_displacements[hash_bucket(h,_buckets)]),_count)];
+	if (little_endian(slot.fingerprint)==hash_fingerprint(h) && word(little_endian(slot.entry))==w) return little_endian(slot.entry);
+	return -1;
+}
+
+int32_t Dictionary::group_search(string_view w) const noexcept {
+	uint32_t first=0,count=_groups;
+	while (count>0) {
+		uint32_t step=count/2;
+		uint32_t it=first+step;
+		if (compare_folded(word(fold_entry(little_endian(_fold_groups[it]))),w)<0) {
+			first=it+1;
+			count-=step+1;
+		} else count=step;
+	}
+	if (first<_groups && compare_folded(word(fold_entry(little_endian(_fold_groups[first]))),w)==0) return first;
+	return -1;
+}
+
+int32_t Dictionary::group_hash(uint64_t h) const noexcept {
+	const auto &slot=_fold_slots[hash_position(h,little_endian(_fold_displacements[hash_bucket(h,_fold_buckets)]),_groups)];
+	if (little_endian(slot.fingerprint)==hash_fingerprint(h)) return little_endian(slot.entry);
+	return -1;
+}
+
+int32_t Dictionary::lookup_group(string_view w,uint64_t h) const noexcept {
+	auto g=(_method==Lookup::HASH)?group_hash(h):group_search(w);
+	if (g==-1) return -1;
+	// The word has an upper-case letter, so that it can only be a member of the group other than its lower-case entry. The comparisons also complete the verification of the group found by its fingerprint only
+	auto lower=little_endian(_fold_lower[g]);
+	auto first=little_endian(_fold_groups[g]),last=little_endian(_fold_groups[g+1]);
+	// Most groups only hold their lower-case entry, whose list of members is then not read
+	if (lower==-1 || last-first>1) for (auto i=first;i<last;++i) {
+		auto e=int32_t(fold_entry(i));
+		if (e!=lower && word(e)==w) return e;
 	}
+	if (lower!=-1 && compare_folded(w,word(lower))==0) return lower;
+	return -1;
 }
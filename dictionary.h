@@ -20,11 +20,12 @@
 #define  DICTIONARY_INC
 
 #include <iostream>
-#include <vector>
-#include <unordered_map>
-#include <algorithm>
-#include <utility>
 #include <string>
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include "format.h"
 
 /**
  * \brief Possible nature of a word (POS)
@@ -41,18 +42,16 @@ enum class Pos {
 /**
  * \brief An entry in the dictionary
  *
- * An entry is made of the nature of a word (POS-tag) and its associated lemma.
+ * An entry is made of the nature of a word (POS-tag) and its associated lemma. The entry does not own its strings, they point directly into the memory-mapped dictionary file.
  */
 class Entry {
 	public:
-		std::wstring word; 	//!< Original word
+		std::string_view word; 	//!< Original word, in UTF-8 encoding
 		Pos pos; 	//!< Part-of-speech tag
-		std::wstring lemma; 	//!< Lemma
+		std::string_view lemma; 	//!< Lemma, in UTF-8 encoding
 		int32_t ilemma; 	//!< Index of the lemma in the dictionary, or -1 if it does not exist
-		Entry(std::wstring pword,Pos ppos,std::wstring plemma,int32_t pilemma):word(pword),pos(ppos),lemma(plemma),ilemma(pilemma) {} 	//!< Construct an entry with its member
+		Entry(std::string_view pword,Pos ppos,std::string_view plemma,int32_t pilemma):word(pword),pos(ppos),lemma(plemma),ilemma(pilemma) {} 	//!< Construct an entry with its member
 		Entry()=default; 	//!< Construct an empty entry
-		Entry(const Entry &s)=default; 	//!< Default copy constructor
-		Entry(Entry &&s)=default; 	//!< Default move constructor
 
 		/**
 		 * \brief Print the entry on an output stream
@@ -60,40 +59,130 @@ class Entry {
 		 * This function may be used for debugging purposes.
 		 * \param out Output stream
 		 */
-		void print(std::wostream &out) const;
+		void print(std::ostream &out) const;
 };
 
-inline bool operator<(const std::wstring &a,const Entry &b) {return a<b.word;}
-inline bool operator<(const Entry &a,const std::wstring &b) {return a.word<b;}
-inline bool operator<(const Entry &a,const Entry &b) {return a.word<b.word;}
-inline std::wostream& operator<<(std::wostream &out,const Entry &a) {a.print(out);return out;}
+inline std::ostream& operator<<(std::ostream &out,const Entry &a) {a.print(out);return out;}
+
+/**
+ * \brief Lookup engine used to find a word in the dictionary
+ */
+enum class Lookup {
+	AUTO, 	//!< Perfect hash table if the dictionary file has one, binary search otherwise
+	SEARCH, 	//!< Binary search over the sorted words
+	HASH 	//!< Minimal perfect hash table built by 'prepare', with fingerprint verification
+};
 
 /**
  * \brief Full dictionary
  *
- * The dictionary has words as keys. Each word is associated to one or several entries.
+ * The dictionary has words as keys. Each word is associated to one entry. The dictionary file is mapped read-only in memory and used in place, so that several processes share the same copy in the page cache. The file is validated once when it is loaded: its checksums are verified and no index read from it may point outside of it. Its integers are little-endian, and are converted on the fly on big-endian computers. Once loaded, the dictionary is never modified: it may be shared by any number of threads without locking.
  */
-class Dictionary:public std::vector<Entry> {
+class Dictionary {
 	public:
 		/**
-		 * \brief Construct a dictionary by reading it from a file
+		 * \brief Construct a dictionary by mapping it from a file
+		 *
+		 * \param path Path name of the file from which the dictionary has to be loaded. The binary dictionary may be generated from a text file using the 'prepare' executable. Its layout is described in format.h.
+		 * \param method Lookup engine used by the lookup method
+		 * \throw std::runtime_error if the file can not be opened, is not a valid dictionary, is corrupt, or has no hash table while the HASH engine is requested
+		 */
+		explicit Dictionary(const std::string &path,Lookup method=Lookup::AUTO);
+
+		Dictionary(const Dictionary&)=delete; 	//!< The mapping can not be copied
+		Dictionary& operator=(const Dictionary&)=delete; 	//!< The mapping can not be copied
+		~Dictionary(); 	//!< Unmap the dictionary file
+
+		/**
+		 * \brief Number of entries in the dictionary
+		 */
+		int32_t size() const noexcept {return int32_t(_count);}
+
+		/**
+		 * \brief Word of an entry
+		 *
+		 * \param i Index of the entry
+		 * \return UTF-8 encoded word
+		 */
+		std::string_view word(int32_t i) const noexcept {
+			auto first=little_endian(_offsets[i]);
+			return std::string_view(_pool+first,little_endian(_offsets[i+1])-first);
+		}
+
+		/**
+		 * \brief POS-tag of an entry
+		 *
+		 * \param i Index of the entry
+		 * \return POS-tag of the word
+		 */
+		Pos pos(int32_t i) const noexcept {
+			switch (_tags[i]) {
+				case 'N':return Pos::NOUN;
+				case 'A':return Pos::ADJ;
+				case 'S':return Pos::STOP;
+				default:return Pos::UNKNOWN;
+			}
+		}
+
+		/**
+		 * \brief Lemma of an entry
+		 *
+		 * \param i Index of the entry
+		 * \return Index of the entry holding the lemma, which is i itself if the word is its own lemma
+		 */
+		int32_t lemma(int32_t i) const noexcept {
+			auto res=little_endian(_lemmas[i]);
+			return (res==-1)?i:res;
+		}
+
+		/**
+		 * \brief Full entry of the dictionary
 		 *
-		 * \param path Path name of the file from which the dictionary has to be loaded. For best performance, a binary format is used. The binary dictionary may be generated from a text file using the 'prepare' executable. For each dictionary entry, the binary file has the following bytes:
-		 *   - one byte for the POS tag, either 'N' for noun or 'A' for adjective, or 'S' for non-significant word (verb, adverb, preposition...)
-		 *   - four bytes which make an int32_t value corresponding to the number of the associated lemma entry (starting with 0)
-		 *   - one byte which stands for the length (read as unsigned char) of the word in UTF-8 encoding 
-		 *   - n bytes for the word, n being the number read in the previous step
+		 * \param i Index of the entry
+		 * \return Entry, whose strings point into the dictionary
 		 */
-		explicit Dictionary(const std::string &path);
+		Entry operator[](int32_t i) const noexcept {return Entry(word(i),pos(i),word(lemma(i)),little_endian(_lemmas[i]));}
 
 		/**
 		 * \brief Look for a word in the dictionary
 		 *
-		 * This function returns the entry associated with the word.
-		 * \param word Word to look for in the dictionary
-		 * \return Associated entry, or empty entry object if no entry is found
+		 * This function returns the index of the entry associated with the word.
+		 * \param word UTF-8 encoded word to look for in the dictionary
+		 * \return Index of the associated entry, or -1 if no entry is found
+		 */
+		int32_t lookup(std::string_view word) const noexcept {return (_method==Lookup::HASH)?lookup_hash(word,hash_word(word)):lookup_search(word);}
+
+		/**
+		 * \brief Look for a word or its lower-case version in the dictionary
+		 *
+		 * The function returns the entry of the word itself if it exists, otherwise the entry of its lower-case version. A word without upper-case letter is looked up like any word. The other words are resolved with a single probe in the index of case-folded words built by 'prepare', without copying their folded version.
+		 * \param word UTF-8 encoded word to look for in the dictionary
+		 * \return Index of the associated entry, or -1 if neither the word nor its lower-case version is found
 		 */
-		std::vector<Entry>::const_iterator lookup(const std::wstring &word) const noexcept {auto it=std::lower_bound(cbegin(),cend(),word);if (it!=cend() && it->word==word) return it;return cend();}
+		int32_t lookup_folded(std::string_view word) const noexcept {
+			// A word without upper-case letter is its own lower-case version, so that it is looked up like any word
+			bool upper;
+			if (_method==Lookup::HASH) {
+				auto h=hash_word(word,&upper);
+				return upper?lookup_group(word,hash_word<true>(word)):lookup_hash(word,h);
+			}
+			upper=std::any_of(word.begin(),word.end(),[](char c){return c!=fold_char(c);});
+			return upper?lookup_group(word,0):lookup_search(word);
+		}
+
+		/**
+		 * \brief Identifier of the dictionary
+		 *
+		 * Each dictionary loaded by the process gets a different identifier, even if it is loaded at the address of a destroyed one, so that the results cached for a dictionary are never used with another one.
+		 */
+		uint64_t id() const noexcept {return _id;}
+
+		/**
+		 * \brief Lookup engine actually used by the dictionary
+		 *
+		 * \return Either Lookup::SEARCH or Lookup::HASH
+		 */
+		Lookup method() const noexcept {return _method;}
 
 		/**
 		 * \brief Print the whole dictionary on an output stream
@@ -101,7 +190,79 @@ class Dictionary:public std::vector<Entry> {
 		 * This function may be used for debugging purposes.
 		 * \param out Output stream
 		 */
-		void print(std::wostream &out) const;
+		void print(std::ostream &out) const;
+
+	private:
+		const char *_data; 	//!< Start of the mapped file
+		std::size_t _length; 	//!< Length of the mapped file
+		uint32_t _count; 	//!< Number of entries
+		const uint32_t *_offsets; 	//!< Offsets of the words in the string pool
+		const int32_t *_lemmas; 	//!< Indices of the lemmas
+		const char *_tags; 	//!< POS tags
+		const char *_pool; 	//!< String pool
+		uint32_t _buckets; 	//!< Number of buckets of the perfect hash function
+		const uint32_t *_displacements; 	//!< Displacements of the buckets of the perfect hash function
+		const Hash_slot *_slots; 	//!< Slots of the perfect hash table
+		uint32_t _groups; 	//!< Number of distinct case-folded words
+		const uint32_t *_fold_order; 	//!< Indices of the entries sorted by case-folded word
+		const uint32_t *_fold_groups; 	//!< Start of each group of entries sharing the same case-folded word
+		const int32_t *_fold_lower; 	//!< Lower-case entry of each group, or -1
+		uint32_t _fold_buckets; 	//!< Number of buckets of the perfect hash function of the folded words
+		const uint32_t *_fold_displacements; 	//!< Displacements of the buckets of the perfect hash function of the folded words
+		const Hash_slot *_fold_slots; 	//!< Slots of the perfect hash table of the folded words
+		Lookup _method; 	//!< Lookup engine
+		uint64_t _id; 	//!< Identifier of the dictionary
+
+		/**
+		 * \brief Entry at some position of the list of entries sorted by case-folded word
+		 *
+		 * \param i Position in the list
+		 * \return Index of the entry
+		 */
+		uint32_t fold_entry(uint32_t i) const noexcept {return little_endian(_fold_order[i]);}
+
+		/**
+		 * \brief Look for a word with a binary search
+		 *
+		 * \param word UTF-8 encoded word to look for in the dictionary
+		 * \return Index of the associated entry, or -1 if no entry is found
+		 */
+		int32_t lookup_search(std::string_view word) const noexcept;
+
+		/**
+		 * \brief Look for a word in the perfect hash table
+		 *
+		 * \param word UTF-8 encoded word to look for in the dictionary
+		 * \param h Hash of the word, as returned by hash_word
+		 * \return Index of the associated entry, or -1 if no entry is found
+		 */
+		int32_t lookup_hash(std::string_view word,uint64_t h) const noexcept;
+
+		/**
+		 * \brief Look for a word with an upper-case letter, or its lower-case version, in the index of case-folded words
+		 *
+		 * \param word UTF-8 encoded word
+		 * \param h Hash of the case-folded word, as returned by hash_word, only used by the perfect hash table
+		 * \return Index of the associated entry, or -1 if neither the word nor its lower-case version is found
+		 */
+		int32_t lookup_group(std::string_view word,uint64_t h) const noexcept;
+
+		/**
+		 * \brief Look for the group of the case-folded version of a word with a binary search
+		 *
+		 * \param word UTF-8 encoded word, which is folded on the fly
+		 * \return Index of the group, or -1 if no group is found
+		 */
+		int32_t group_search(std::string_view word) const noexcept;
+
+		/**
+		 * \brief Look for the group of a case-folded word in the perfect hash table
+		 *
+		 * Only the fingerprint of the word is checked, the caller must still compare the word with the members of the group.
+		 * \param h Hash of the case-folded word, as returned by hash_word
+		 * \return Index of the candidate group, or -1 if no group is found
+		 */
+		int32_t group_hash(uint64_t h) const noexcept;
 };
 
 #endif   /* ----- #ifndef DICTIONARY_INC  ----- */
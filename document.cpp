@@ -0,0 +1,233 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  document.cpp
+ *
+ *    Description:  Implementation of the readers and writers of the batch mode
+ *
+ *        Version:  1.0
+ *        Created:  18/10/2026 10:17:36
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  François Hissel
+ *   Organization:
+ *
+ * =====================================================================================
+ */
+
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <limits>
+#include "profile.h"
+#include "graph.h"
+#include "document.h"
+
+using namespace std;
+
+/**
+ * \brief Build a JSON string
+ */
+static Json json_string(string s) {
+	Json res;
+	res.type=Json_type::STRING;
+	res.string=move(s);
+	return res;
+}
+
+/**
+ * \brief Build a JSON number
+ */
+static Json json_number(double x) {
+	Json res;
+	res.type=Json_type::NUMBER;
+	res.number=x;
+	return res;
+}
+
+/**
+ * \brief Read an integer parameter of a JSON request
+ *
+ * \param request JSON object
+ * \param name Name of the parameter
+ * \param value Value of the parameter, unchanged if the object has no such member
+ * \param high Largest valid value
+ * \throw std::runtime_error if the member is not an integer between 0 and high
+ */
+static void read_parameter(const Json &request,const char *name,int &value,int high=1000000000) {
+	auto member=request.find(name);
+	if (member==nullptr) return;
+	if (member->type!=Json_type::NUMBER || member->number<0 || member->number>high || member->number!=int(member->number)) throw runtime_error(string("Parameter \"")+name+"\" must be an integer between 0 and "+to_string(high));
+	value=int(member->number);
+}
+
+/**
+ * \brief Read a real parameter of a JSON request
+ *
+ * \param request JSON object
+ * \param name Name of the parameter
+ * \param value Value of the parameter, unchanged if the object has no such member
+ * \param high Largest valid value
+ * \throw std::runtime_error if the member is not a number between 0 and high
+ */
+static void read_parameter(const Json &request,const char *name,double &value,double high) {
+	auto member=request.find(name);
+	if (member==nullptr) return;
+	if (member->type!=Json_type::NUMBER || !(member->number>=0 && member->number<=high)) throw runtime_error(string("Parameter \"")+name+"\" must be a number between 0 and "+to_string(high));
+	value=member->number;
+}
+
+/**
+ * \brief Read a boolean parameter of a JSON request
+ *
+ * \param request JSON object
+ * \param name Name of the parameter
+ * \param value Value of the parameter, unchanged if the object has no such member
+ * \throw std::runtime_error if the member is not a boolean
+ */
+static void read_parameter(const Json &request,const char *name,bool &value) {
+	auto member=request.find(name);
+	if (member==nullptr) return;
+	if (member->type!=Json_type::BOOLEAN) throw runtime_error(string("Parameter \"")+name+"\" must be a boolean");
+	value=member->boolean;
+}
+
+/**
+ * \brief Read the solver of a JSON request
+ *
+ * \param request JSON object
+ * \param name Name of the parameter
+ * \param value Value of the parameter, unchanged if the object has no such member
+ * \throw std::runtime_error if the member is not the name of a solver
+ */
+static void read_parameter(const Json &request,const char *name,Solver &value) {
+	auto member=request.find(name);
+	if (member==nullptr) return;
+	if (member->type!=Json_type::STRING) throw runtime_error(string("Parameter \"")+name+"\" must be the name of a solver");
+	try {
+		value=solver_from_name(member->string);
+	} catch (const invalid_argument &e) {
+		throw runtime_error(e.what());
+	}
+}
+
+/*********************************************
+ *            Document_reader                *
+ *********************************************/
+Document_reader::Document_reader(vector<string> paths):_format(Input::FILES),_in(nullptr),_paths(move(paths)),_count(0),_max_iterations(1000000000) {
+}
+
+Document_reader::Document_reader(istream &in,Input format,int max_iterations):_format(format),_in(&in),_count(0),_max_iterations(max_iterations) {
+	if (format==Input::FILES) throw invalid_argument("A stream of documents cannot be a list of files");
+}
+
+bool Document_reader::next(Document &doc) {
+	doc.text.clear();
+	doc.error.clear();
+	switch (_format) {
+		case Input::FILES: {
+			if (_count>=_paths.size()) return false;
+			const auto &path=_paths[_count++];
+			doc.id=json_string(path);
+			ifstream ifs(path,ifstream::binary);
+			if (!ifs) {
+				doc.error="Unable to open "+path;
+				return true;
+			}
+			doc.text.assign(istreambuf_iterator<char>(ifs),istreambuf_iterator<char>());
+			return true;
+		}
+		case Input::NUL:
+			if (!getline(*_in,doc.text,'\0')) return false;
+			doc.id=json_number(double(_count++));
+			return true;
+		case Input::JSONL:
+			// Blank lines are not documents
+			do {
+				if (!getline(*_in,_line)) return false;
+			} while (_line.find_first_not_of(" \t\r")==string::npos);
+			doc.id=json_number(double(_count++));
+			try {
+				auto value=Json::parse(_line);
+				if (value.type==Json_type::STRING) doc.text=move(value.string);
+				else {
+					auto id=value.find("id");
+					if (id!=nullptr) doc.id=*id;
+					auto text=value.find("text");
+					if (text==nullptr || text->type!=Json_type::STRING) doc.error="Missing \"text\" string member";
+					else doc.text=text->string;
+					read_parameter(value,"window",doc.window_size);
+					read_parameter(value,"keywords",doc.parameters.num_keywords);
+					read_parameter(value,"iterations",doc.parameters.max_iterations,_max_iterations);
+					read_parameter(value,"damping",doc.parameters.damping,1.0);
+					read_parameter(value,"tolerance",doc.parameters.tolerance,numeric_limits<double>::max());
+					read_parameter(value,"solver",doc.parameters.solver);
+					read_parameter(value,"profile",doc.profile);
+				}
+			} catch (const runtime_error &e) {
+				doc.error=e.what();
+			}
+			return true;
+	}
+	return false;
+}
+
+/*********************************************
+ *             Result records                *
+ *********************************************/
+Json profile_record(const Profile &profile) {
+	Json record;
+	record.type=Json_type::OBJECT;
+	Json time;
+	time.type=Json_type::OBJECT;
+	for (int i=0;i<STAGES;++i) {
+		Json stage;
+		stage.type=Json_type::OBJECT;
+		stage.object.emplace_back("wall",json_number(profile.wall(Stage(i))*1e3));
+		stage.object.emplace_back("cpu",json_number(profile.cpu(Stage(i))*1e3));
+		time.object.emplace_back(stage_name(Stage(i)),move(stage));
+	}
+	record.object.emplace_back("time",move(time));
+	Json counters;
+	counters.type=Json_type::OBJECT;
+	for (int i=0;i<COUNTERS;++i) counters.object.emplace_back(counter_name(Counter(i)),json_number(double(profile.counter(Counter(i)))));
+	record.object.emplace_back("counters",move(counters));
+	return record;
+}
+
+Json result_record(const Document &doc,const Ranking &res,bool stats,const Timing &timing,const Profile &profile) {
+	Json record;
+	record.type=Json_type::OBJECT;
+	record.object.emplace_back("id",doc.id);
+	if (!doc.error.empty()) {
+		record.object.emplace_back("error",json_string(doc.error));
+		return record;
+	}
+	Json keywords;
+	keywords.type=Json_type::ARRAY;
+	keywords.array.reserve(res.size());
+	for (const auto &[word,score]:res) {
+		Json keyword;
+		keyword.type=Json_type::OBJECT;
+		keyword.object.emplace_back("keyword",json_string(word));
+		keyword.object.emplace_back("score",json_number(score));
+		keywords.array.push_back(move(keyword));
+	}
+	record.object.emplace_back("keywords",move(keywords));
+	if (stats) {
+		record.object.emplace_back("iterations",json_number(res.iterations));
+		record.object.emplace_back("residual",json_number(res.residual));
+		record.object.emplace_back("traversals",json_number(double(res.traversals)));
+		Json time;
+		time.type=Json_type::OBJECT;
+		time.object.emplace_back("graph",json_number(timing.graph));
+		time.object.emplace_back("rank",json_number(timing.rank));
+		record.object.emplace_back("time",move(time));
+	}
+	if (doc.profile) record.object.emplace_back("profile",profile_record(profile));
+	return record;
+}
@@ -0,0 +1,130 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  document.h
+ *
+ *    Description:  Documents of the batch mode: readers of the lists of documents and
+ *    				writer of the result records
+ *
+ *        Version:  1.0
+ *        Created:  18/10/2026 10:02:41
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  François Hissel
+ *   Organization:
+ *
+ * =====================================================================================
+ */
+
+#ifndef  DOCUMENT_INC
+#define  DOCUMENT_INC
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include "json.h"
+#include "profile.h"
+#include "graph.h"
+
+/**
+ * \brief Default largest number of iterations a request to the server may ask for, so that a single request can not hold a worker for long
+ */
+constexpr int MAX_REQUEST_ITERATIONS=10000;
+
+/**
+ * \brief Format of the list of documents in batch mode
+ */
+enum class Input {
+	FILES, 	//!< Each document is a file given on the command line
+	JSONL, 	//!< Each line of the stream is a JSON object with a "text" member, an optional "id" member and optional parameters, or a JSON string
+	NUL 	//!< Documents are separated by NUL characters
+};
+
+/**
+ * \brief Document read in batch mode
+ */
+struct Document {
+	Json id; 	//!< Identifier of the document, copied to its result record: the file name, the "id" member of the JSON object or the rank of the document in the stream
+	std::string text; 	//!< UTF-8 encoded text of the document
+	std::string error; 	//!< Reason why the document could not be read, empty if it was read successfully
+	int window_size=3; 	//!< Size of the window for linked edges
+	Rank_parameters parameters; 	//!< Parameters of the TextRank algorithm
+	bool profile=false; 	//!< Add the time and counters of each stage to the result record
+};
+
+/**
+ * \brief Time spent on a document
+ */
+struct Timing {
+	double graph=0.0; 	//!< Time spent to build the graph, in milliseconds
+	double rank=0.0; 	//!< Time spent to rank the nodes and assemble the keywords, in milliseconds
+};
+
+/**
+ * \brief Reader of the documents of a batch
+ *
+ * The reader only holds one document at a time, so that streams of any length may be processed.
+ */
+class Document_reader {
+	public:
+		/**
+		 * \brief Create a reader of a list of files
+		 *
+		 * \param paths Paths of the files, each file being a document
+		 */
+		explicit Document_reader(std::vector<std::string> paths);
+
+		/**
+		 * \brief Create a reader of a stream of documents
+		 *
+		 * \param in Input stream, which must outlive the reader
+		 * \param format Format of the stream, either Input::JSONL or Input::NUL
+		 * \param max_iterations Largest number of iterations a JSON object may ask for. A document which asks for more gets an error
+		 */
+		Document_reader(std::istream &in,Input format,int max_iterations=1000000000);
+
+		/**
+		 * \brief Read the next document
+		 *
+		 * A document which cannot be read, for instance a missing file or an invalid JSON line, is still returned with a non-empty error, so that the batch goes on with the next documents.
+		 *
+		 * The members "window", "keywords", "iterations", "damping", "tolerance", "solver" and "profile" of a JSON object override the size of the window and the parameters of the document. The parameters missing from the object, and the parameters of the other formats, keep the value they have in doc when the function is called.
+		 * \param doc Next document, only set if the function returns true
+		 * \return False if there is no more document
+		 */
+		bool next(Document &doc);
+
+	private:
+		Input _format; 	//!< Format of the list of documents
+		std::istream *_in; 	//!< Input stream of the documents if they are not files
+		std::vector<std::string> _paths; 	//!< Paths of the files if the documents are files
+		std::size_t _count; 	//!< Number of documents already read
+		int _max_iterations; 	//!< Largest number of iterations a JSON object may ask for
+		std::string _line; 	//!< Buffer of the last line read from a JSONL stream
+};
+
+/**
+ * \brief Build the JSON record of a profile
+ *
+ * The record is a JSON object with a "time" member, which gives the wall-clock and CPU time of each stage in milliseconds, and a "counters" member.
+ * \param profile Profile
+ * \return Record of the profile
+ */
+Json profile_record(const Profile &profile);
+
+/**
+ * \brief Build the result record of a document
+ *
+ * The record is a JSON object with the identifier of the document and the list of keywords and scores, or the reason of the failure.
+ * \param doc Document
+ * \param res Keywords of the document, ignored if the document could not be read
+ * \param stats Add the number of iterations, the final residual and the time spent to the record
+ * \param timing Time spent on the document, only used if stats is true
+ * \param profile Time and counters of the stages of the document, only used if the profile of the document was requested
+ * \return Result record
+ */
+Json result_record(const Document &doc,const Ranking &res,bool stats,const Timing &timing=Timing(),const Profile &profile=Profile());
+
+#endif   /* ----- #ifndef DOCUMENT_INC  ----- */
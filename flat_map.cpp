@@ -0,0 +1,65 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  flat_map.cpp
+ *
+ *    Description:  Implementation of the open-addressing hash table
+ *
+ *        Version:  1.0
+ *        Created:  21/10/2026 15:40:31
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  François Hissel
+ *   Organization:
+ *
+ * =====================================================================================
+ */
+
+#include <vector>
+#include <utility>
+#include "flat_map.h"
+
+using namespace std;
+
+/*********************************************
+ *                Flat_map                   *
+ *********************************************/
+void Flat_map::reserve(size_t capacity) {
+	size_t slots=16;
+	int shift=60;
+	while (slots<2*capacity) {
+		slots*=2;
+		--shift;
+	}
+	if (slots<=_slots.size()) return;
+	vector<Slot> old(slots,Slot{EMPTY,0});
+	old.swap(_slots);
+	_shift=shift;
+	auto mask=_slots.size()-1;
+	for (const auto &it:old) if (it.key!=EMPTY) {
+		auto i=index(it.key);
+		while (_slots[i].key!=EMPTY) i=(i+1)&mask;
+		_slots[i]=it;
+	}
+}
+
+void Flat_map::erase(uint64_t key) noexcept {
+	if (_size==0) return;
+	auto mask=_slots.size()-1;
+	auto i=index(key);
+	while (_slots[i].key!=key) {
+		if (_slots[i].key==EMPTY) return;
+		i=(i+1)&mask;
+	}
+	// Move back the following elements of the cluster which may not be reached anymore from their first slot
+	for (auto j=(i+1)&mask;_slots[j].key!=EMPTY;j=(j+1)&mask) {
+		auto home=index(_slots[j].key);
+		// The element stays if its first slot lies cyclically in (i,j]
+		if ((i<j)?(home>i && home<=j):(home>i || home<=j)) continue;
+		_slots[i]=_slots[j];
+		i=j;
+	}
+	_slots[i].key=EMPTY;
+	--_size;
+}
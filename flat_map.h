@@ -0,0 +1,136 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  flat_map.h
+ *
+ *    Description:  Open-addressing hash table from 64-bit keys to 32-bit values
+ *
+ *        Version:  1.0
+ *        Created:  21/10/2026 15:12:09
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  François Hissel
+ *   Organization:
+ *
+ * =====================================================================================
+ */
+
+#ifndef  FLAT_MAP_INC
+#define  FLAT_MAP_INC
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * \brief Hash table from 64-bit keys to 32-bit values
+ *
+ * All the elements are stored in a single array, with linear probing, so that the table only calls the allocator when it grows, and a lookup reads one or two cache lines. The load factor is kept under 1/2. Erased elements are not marked as deleted: the following elements of their probe sequence are moved back instead, so that the table does not degrade after many insertions and removals. The key ~0 is reserved to mark the empty slots.
+ */
+class Flat_map {
+	public:
+		static constexpr uint64_t EMPTY=~uint64_t(0); 	//!< Key of the empty slots, which can not be stored in the table
+
+		/**
+		 * \brief Create an empty table
+		 *
+		 * \param capacity Number of elements which may be inserted before the table grows
+		 */
+		explicit Flat_map(std::size_t capacity=0):_size(0),_shift(64) {reserve(capacity);}
+
+		/**
+		 * \brief Grow the table so that it holds a number of elements without growing again
+		 *
+		 * \param capacity Number of elements
+		 */
+		void reserve(std::size_t capacity);
+
+		/**
+		 * \brief Value of a key, inserted with the value 0 if it is not in the table
+		 *
+		 * \param key Key, which must not be EMPTY
+		 * \return Reference to the value, which is valid until the next insertion or removal
+		 */
+		int32_t &operator[](uint64_t key) {
+			if (2*(_size+1)>_slots.size()) reserve(_size+1);
+			auto mask=_slots.size()-1;
+			for (auto i=index(key);;i=(i+1)&mask) {
+				auto &slot=_slots[i];
+				if (slot.key==key) return slot.value;
+				if (slot.key==EMPTY) {
+					slot.key=key;
+					slot.value=0;
+					++_size;
+					return slot.value;
+				}
+			}
+		}
+
+		/**
+		 * \brief Find a key
+		 *
+		 * \param key Key
+		 * \return Pointer to the value of the key, which is valid until the next insertion or removal, or nullptr if the key is not in the table
+		 */
+		int32_t *find(uint64_t key) noexcept {
+			if (_size==0) return nullptr;
+			auto mask=_slots.size()-1;
+			for (auto i=index(key);_slots[i].key!=EMPTY;i=(i+1)&mask) if (_slots[i].key==key) return &_slots[i].value;
+			return nullptr;
+		}
+
+		/**
+		 * \brief Remove a key from the table
+		 *
+		 * \param key Key, which does nothing if it is not in the table
+		 */
+		void erase(uint64_t key) noexcept;
+
+		/**
+		 * \brief Number of elements of the table
+		 */
+		std::size_t size() const noexcept {return _size;}
+
+		/**
+		 * \brief Call a function for each element of the table, in an unspecified order
+		 *
+		 * \param f Function called with the key and the value of each element
+		 */
+		template<class Function> void for_each(Function f) const {
+			for (const auto &it:_slots) if (it.key!=EMPTY) f(it.key,it.value);
+		}
+
+		/**
+		 * \brief Remove all the elements and release the memory of the table
+		 */
+		void clear() noexcept {
+			std::vector<Slot>().swap(_slots);
+			_size=0;
+			_shift=64;
+		}
+
+	private:
+		/**
+		 * \brief Slot of the table
+		 */
+		struct Slot {
+			uint64_t key; 	//!< Key, or EMPTY if the slot is free
+			int32_t value; 	//!< Value
+		};
+
+		std::vector<Slot> _slots; 	//!< Slots of the table, whose number is a power of 2
+		std::size_t _size; 	//!< Number of elements
+		int _shift; 	//!< Number of bits of a 64-bit hash which are dropped to get a slot
+
+		/**
+		 * \brief First slot of the probe sequence of a key
+		 *
+		 * The key is multiplied by a large odd constant, and the upper bits of the product give the slot, so that consecutive keys are spread over the table.
+		 * \param key Key
+		 * \return Index of the slot
+		 */
+		std::size_t index(uint64_t key) const noexcept {return (_shift==64)?0:std::size_t((key*0x9E3779B97F4A7C15ull)>>_shift);}
+};
+
+#endif   /* ----- #ifndef FLAT_MAP_INC  ----- */
@@ -0,0 +1,325 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  format.h
+ *
+ *    Description:  Layout of the binary dictionary file, shared by the 'prepare'
+ *    				generator and the dictionary loader
+ *
+ *        Version:  1.0
+ *        Created:  17/10/2026 09:12:40
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  François Hissel
+ *   Organization:
+ *
+ * =====================================================================================
+ */
+
+#ifndef  FORMAT_INC
+#define  FORMAT_INC
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+#include <algorithm>
+
+/**
+ * \brief Magic number at the beginning of a binary dictionary file
+ */
+constexpr char DICTIONARY_MAGIC[4]={'T','R','K','D'};
+
+/**
+ * \brief Version of the binary dictionary format
+ *
+ * The version is increased each time the layout changes. Files with another version are rejected by the loader and must be generated again with 'prepare'.
+ */
+constexpr uint32_t DICTIONARY_VERSION=5;
+
+/**
+ * \brief Sections of the binary dictionary file
+ */
+enum class Section {
+	OFFSETS, 	//!< Offsets of the words in the string pool
+	LEMMAS, 	//!< Lemma entry of each word
+	TAGS, 	//!< POS tag of each word
+	DISPLACEMENTS, 	//!< Displacements of the perfect hash function
+	SLOTS, 	//!< Slots of the perfect hash table
+	FOLD_ORDER, 	//!< Entries sorted by case-folded word
+	FOLD_GROUPS, 	//!< Groups of entries sharing the same case-folded word
+	FOLD_LOWER, 	//!< Lower-case entry of each group
+	FOLD_DISPLACEMENTS, 	//!< Displacements of the perfect hash function of the folded words
+	FOLD_SLOTS, 	//!< Slots of the perfect hash table of the folded words
+	POOL 	//!< String pool
+};
+
+constexpr int SECTIONS=11; 	//!< Number of sections
+
+/**
+ * \brief Alignment of the sections in the file, in bytes
+ */
+constexpr std::size_t SECTION_ALIGNMENT=8;
+
+/**
+ * \brief Location of a section in the binary dictionary file
+ */
+struct Section_entry {
+	uint64_t offset; 	//!< Offset of the section from the beginning of the file, a multiple of SECTION_ALIGNMENT
+	uint64_t size; 	//!< Size of the section in bytes
+	uint64_t checksum; 	//!< Checksum of the bytes of the section, as returned by checksum
+};
+
+/**
+ * \brief Header of the binary dictionary file
+ *
+ * All the integers of the file, including those of the header, are stored in little-endian byte order, whatever the computer which generated it, so that a dictionary may be generated once and used on any computer. The header gives the location and the checksum of each section. Sections follow the header in the order below, each one starting at a multiple of SECTION_ALIGNMENT bytes, the gaps being filled with zeros:
+ *   - offsets: count+1 uint32_t values. Word i is made of the bytes [offsets[i],offsets[i+1]) of the string pool
+ *   - lemmas: count int32_t values. Index of the lemma entry of each word, or -1 if the word is its own lemma
+ *   - tags: count bytes, padded with zeros to a multiple of 4 bytes. POS tag of each word, 'N' for noun, 'A' for adjective, 'S' for non-significant word and ' ' for unknown
+ *   - displacements: hash_buckets uint32_t values. Displacement of each bucket of the perfect hash function
+ *   - slots: count Hash_slot values if hash_buckets is not 0. Entry and fingerprint stored in each slot of the perfect hash table
+ *   - fold order: count uint32_t values. Indices of the entries sorted by their case-folded word, so that the entries sharing the same folded word make a contiguous group
+ *   - fold groups: groups+1 uint32_t values. Group i is made of the elements [groups[i],groups[i+1]) of the fold order
+ *   - fold lower: groups int32_t values. Index of the entry of each group whose word is already in lower case, or -1 if there is none
+ *   - fold displacements: fold_buckets uint32_t values. Displacement of each bucket of the perfect hash function of the folded words
+ *   - fold slots: groups Hash_slot values if fold_buckets is not 0. Group and fingerprint stored in each slot of the perfect hash table of the folded words
+ *   - pool: pool_size bytes. Concatenation of all the words in UTF-8 encoding, sorted by byte order
+ */
+struct Dictionary_header {
+	char magic[4]; 	//!< Magic number, equal to DICTIONARY_MAGIC
+	uint32_t version; 	//!< Version of the format, equal to DICTIONARY_VERSION
+	uint32_t count; 	//!< Number of entries
+	uint32_t pool_size; 	//!< Size of the string pool in bytes
+	uint32_t hash_buckets; 	//!< Number of buckets of the perfect hash function, 0 if the file has no hash table
+	uint32_t groups; 	//!< Number of distinct case-folded words
+	uint32_t fold_buckets; 	//!< Number of buckets of the perfect hash function of the folded words, 0 if the file has no hash table
+	uint32_t reserved; 	//!< Unused, always 0
+	Section_entry sections[SECTIONS]; 	//!< Location and checksum of each section, in the order of the Section enumeration
+	uint64_t checksum; 	//!< Checksum of the bytes of the header which precede this member
+};
+
+/**
+ * \brief Conversion between the byte order of the computer and the little-endian byte order of the file
+ *
+ * The conversion is its own inverse, and does nothing on little-endian computers.
+ * \param v Value
+ * \return Value with its bytes swapped on big-endian computers
+ */
+inline uint32_t little_endian(uint32_t v) noexcept {
+#if __BYTE_ORDER__==__ORDER_BIG_ENDIAN__
+	return __builtin_bswap32(v);
+#else
+	return v;
+#endif
+}
+
+/**
+ * \brief Conversion between the byte order of the computer and the little-endian byte order of the file
+ */
+inline int32_t little_endian(int32_t v) noexcept {return int32_t(little_endian(uint32_t(v)));}
+
+/**
+ * \brief Conversion between the byte order of the computer and the little-endian byte order of the file
+ */
+inline uint64_t little_endian(uint64_t v) noexcept {
+#if __BYTE_ORDER__==__ORDER_BIG_ENDIAN__
+	return __builtin_bswap64(v);
+#else
+	return v;
+#endif
+}
+
+/**
+ * \brief Slot of the minimal perfect hash table
+ */
+struct Hash_slot {
+	uint32_t entry; 	//!< Index of the entry whose word is hashed to this slot
+	uint32_t fingerprint; 	//!< Fingerprint of the word, used to reject most unknown words without reading the string pool
+};
+
+/**
+ * \brief Size in bytes of the tags section, including padding
+ *
+ * \param count Number of entries in the dictionary
+ * \return Size of the section
+ */
+constexpr std::size_t tags_size(uint32_t count) {return (std::size_t(count)+3)/4*4;}
+
+/**
+ * \brief Case-folding of a byte of a UTF-8 word
+ *
+ * Only ASCII letters are folded, which is what the lower-case conversion of the classic locale does. Bytes of multi-byte sequences are left unchanged.
+ * \param c Byte of the word
+ * \return Folded byte
+ */
+constexpr char fold_char(char c) {return (c>='A' && c<='Z')?char(c-'A'+'a'):c;}
+
+/**
+ * \brief Find the ASCII upper-case letters among eight bytes of a UTF-8 word
+ *
+ * The bytes are tested without branches, by adding to their low seven bits the offsets which carry into their high bit from 'A' and from the byte after 'Z'.
+ * \param v Bytes of the word
+ * \return Bytes whose high bit is set if the byte of v at the same place is an upper-case letter, and whose other bits are 0
+ */
+inline uint64_t upper_block(uint64_t v) noexcept {
+	constexpr uint64_t ones=0x0101010101010101ull;
+	auto low=v&(0x7F*ones);
+	return ~v&((low+(0x80-'A')*ones)^(low+(0x7F-'Z')*ones))&(0x80*ones);
+}
+
+/**
+ * \brief Case-folding of eight bytes of a UTF-8 word at once
+ *
+ * The bytes are folded as by fold_char.
+ * \param v Bytes of the word
+ * \return Folded bytes
+ */
+inline uint64_t fold_block(uint64_t v) noexcept {return v|(upper_block(v)>>2);}
+
+/**
+ * \brief Hash a word or its case-folded version
+ *
+ * The same function is used by 'prepare' to build the perfect hash tables and by the loader to query them, so it must never change without a new format version. The folded version of a word is hashed without being copied, and its hash is the hash of the folded word.
+ * \tparam Fold If true, hash the case-folded version of the word
+ * \param w UTF-8 encoded word
+ * \param upper If not nullptr, set to true if the word has an upper-case letter, that is if it is not its own case-folded version
+ * \return 64-bit hash value
+ */
+template<bool Fold=false> inline uint64_t hash_word(std::string_view w,bool *upper=nullptr) noexcept {
+	constexpr uint64_t k=0x9E3779B97F4A7C15ull;
+	uint64_t h=w.size()*k;
+	uint64_t letters=0;
+	auto block=[&](uint64_t v) {
+		if (upper!=nullptr) letters|=upper_block(v);
+		if constexpr (Fold) return fold_block(v); else return v;
+	};
+	const char *p=w.data();
+	std::size_t n=w.size();
+	while (n>=8) {
+		uint64_t v;
+		std::memcpy(&v,p,8);
+		h=(h^little_endian(block(v)))*k;
+		h^=h>>29;
+		p+=8;
+		n-=8;
+	}
+	if (n>0) {
+		uint64_t v=0;
+		std::memcpy(&v,p,n);
+		h=(h^little_endian(block(v)))*k;
+	}
+	h^=h>>32;
+	h*=0xD6E8FEB86659FD93ull;
+	h^=h>>32;
+	if (upper!=nullptr) *upper=(letters!=0);
+	return h;
+}
+
+/**
+ * \brief Reduce a 32-bit value to a range
+ *
+ * The product by the size of the range replaces a modulo, which is several times slower.
+ * \param v Value
+ * \param n Size of the range
+ * \return Value in [0,n)
+ */
+inline uint32_t reduce_range(uint32_t v,uint32_t n) noexcept {return uint32_t((uint64_t(v)*n)>>32);}
+
+/**
+ * \brief Bucket of a word in the perfect hash function
+ *
+ * \param h Hash of the word, as returned by hash_word
+ * \param buckets Number of buckets
+ * \return Bucket index
+ */
+inline uint32_t hash_bucket(uint64_t h,uint32_t buckets) noexcept {return reduce_range(uint32_t(h>>32),buckets);}
+
+/**
+ * \brief Slot of a word in the perfect hash table
+ *
+ * \param h Hash of the word, as returned by hash_word
+ * \param displacement Displacement of the bucket of the word
+ * \param slots Number of slots, which is the number of entries
+ * \return Slot index
+ */
+inline uint32_t hash_position(uint64_t h,uint32_t displacement,uint32_t slots) noexcept {
+	uint64_t x=h^(uint64_t(displacement)*0xC2B2AE3D27D4EB4Full);
+	x^=x>>33;
+	x*=0xFF51AFD7ED558CCDull;
+	x^=x>>33;
+	return reduce_range(uint32_t(x>>32),slots);
+}
+
+/**
+ * \brief Fingerprint of a word stored in its hash slot
+ *
+ * \param h Hash of the word, as returned by hash_word
+ * \return Fingerprint
+ */
+inline uint32_t hash_fingerprint(uint64_t h) noexcept {return uint32_t(h);}
+
+/**
+ * \brief Size of the blocks of the checksum, in bytes
+ *
+ * The loader checks the content of each block of a section just after its checksum, while it is still in the cache, so that the whole file is validated in a single pass.
+ */
+constexpr std::size_t CHECKSUM_BLOCK=65536;
+
+/**
+ * \brief Rotate the bits of a 64-bit value to the left
+ */
+constexpr uint64_t rotate_left(uint64_t v,int n) {return (v<<n)|(v>>(64-n));}
+
+/**
+ * \brief Checksum of a block of bytes
+ *
+ * Four independent accumulators read 8 bytes each per step, so that the checksum runs at the speed of the memory.
+ * \param data Bytes
+ * \param size Number of bytes, at most CHECKSUM_BLOCK
+ * \param seed Checksum of the previous blocks, 0 for the first one
+ * \return Checksum of the previous blocks and of this one
+ */
+inline uint64_t checksum_block(const char *data,std::size_t size,uint64_t seed) noexcept {
+	constexpr uint64_t k1=0x9E3779B185EBCA87ull;
+	constexpr uint64_t k2=0xC2B2AE3D27D4EB4Full;
+	auto mix=[](uint64_t acc,uint64_t v) {return rotate_left(acc+v*k2,31)*k1;};
+	auto load=[](const char *p) {uint64_t v;std::memcpy(&v,p,8);return little_endian(v);};
+	uint64_t a=seed+k1+k2,b=seed+k2,c=seed,d=seed-k1;
+	std::size_t n=size;
+	for (;n>=32;n-=32,data+=32) {
+		a=mix(a,load(data));
+		b=mix(b,load(data+8));
+		c=mix(c,load(data+16));
+		d=mix(d,load(data+24));
+	}
+	uint64_t h=rotate_left(a,1)+rotate_left(b,7)+rotate_left(c,12)+rotate_left(d,18)+size;
+	for (;n>=8;n-=8,data+=8) h=rotate_left(h^mix(0,load(data)),27)*k1;
+	if (n>0) {
+		uint64_t v=0;
+		std::memcpy(&v,data,n);
+		h=rotate_left(h^mix(0,little_endian(v)),27)*k1;
+	}
+	h^=h>>33;
+	h*=k2;
+	h^=h>>29;
+	h*=k1;
+	h^=h>>32;
+	return h;
+}
+
+/**
+ * \brief Checksum of a section of the binary dictionary
+ *
+ * \param data Bytes of the section
+ * \param size Size of the section
+ * \return Checksum of the blocks of the section, chained from the first one to the last one
+ */
+inline uint64_t checksum(const char *data,std::size_t size) noexcept {
+	uint64_t res=0;
+	for (std::size_t i=0;i<size;i+=CHECKSUM_BLOCK) res=checksum_block(data+i,std::min(CHECKSUM_BLOCK,size-i),res);
+	return res;
+}
+
+#endif   /* ----- #ifndef FORMAT_INC  ----- */
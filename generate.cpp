@@ -0,0 +1,171 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  generate.cpp
+ *
+ *    Description:  Generation of a synthetic dictionary and of a synthetic text for the
+ *    				benchmarks. The dictionary is written in the input format of
+ *    				'prepare'.
+ *
+ *        Version:  1.0
+ *        Created:  20/10/2026 16:05:41
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  François Hissel
+ *   Organization:
+ *
+ * =====================================================================================
+ */
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <unordered_set>
+#include <algorithm>
+#include <random>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+
+using namespace std;
+
+/**
+ * \brief Pseudo-random generator giving the same sequence on every platform
+ *
+ * The standard distributions are implementation-defined, so that only the raw output of the Mersenne twister is used.
+ */
+class Random {
+	public:
+		/**
+		 * \brief Create the generator
+		 *
+		 * \param seed Seed of the sequence
+		 */
+		explicit Random(uint64_t seed):_engine(seed) {}
+
+		/**
+		 * \brief Uniform real number in [0,1)
+		 */
+		double real() {return (_engine()>>11)*0x1.0p-53;}
+
+		/**
+		 * \brief Uniform integer in [low,high]
+		 */
+		uint64_t integer(uint64_t low,uint64_t high) {return low+uint64_t(real()*(high-low+1));}
+
+	private:
+		mt19937_64 _engine; 	//!< Mersenne twister
+};
+
+/**
+ * \brief Letters of the generated words. Accented letters make the words multi-byte in UTF-8, as in French
+ */
+static const vector<string> letters={"a","b","c","d","e","f","g","h","i","j","k","l","m","n","o","p","q","r","s","t","u","v","w","x","y","z","e","a","i","e","é","è","à","ç","ô","û"};
+
+/**
+ * \brief Stop words of the dictionary, which are the most frequent words of the text
+ */
+static const vector<string> stop_words={"les","des","une","dans","pour","avec","sur","par","qui","que","est","sont","cette","mais","plus","pas","aux","ces","leur","elle","nous","vous","ils","comme","tout"};
+
+/**
+ * \brief Generate a random word which was not generated yet
+ *
+ * \param random Pseudo-random generator
+ * \param used Words already generated, to which the new word is added
+ * \return New word, in UTF-8 encoding
+ */
+string new_word(Random &random,unordered_set<string> &used) {
+	for (;;) {
+		string res;
+		auto length=random.integer(4,10);
+		for (uint64_t i=0;i<length;++i) res+=letters[random.integer(0,letters.size()-1)];
+		// The word must not be the inflected form of another word, nor the base of another inflected form
+		if (used.count(res)>0 || used.count(res+"s")>0 || used.count(res+"e")>0 || used.count(res+"nt")>0) continue;
+		used.insert(res);
+		return res;
+	}
+}
+
+/**
+ * \brief Main program
+ *
+ * \param argc Number of command-line arguments, including the name of the program
+ * \param argv Array or command-line arguments, the first element is the name of the program
+ * \return 0 if the execution was successful, an error code otherwise
+ */
+int main(int argc,char *argv[]) {
+	if (argc<3) {
+		cerr << "Syntax: generate path_to_text_dictionary path_to_text [lemmas] [words] [skew] [seed] [topics]\n"
+			"  lemmas  Number of lemmas of the dictionary (default: 20000)\n"
+			"  words   Number of words of the text (default: 100000)\n"
+			"  skew    Exponent of the Zipf law of the frequencies of the words in the text (default: 1)\n"
+			"  seed    Seed of the pseudo-random generator (default: 1)\n"
+			"  topics  Number of topics of the text, each sentence drawing its words from the vocabulary of its topic (default: 1)\n";
+		return 1;
+	}
+	try {
+		size_t lemmas=(argc>3)?stoul(argv[3]):20000;
+		size_t words=(argc>4)?stoul(argv[4]):100000;
+		double skew=(argc>5)?stod(argv[5]):1.0;
+		Random random((argc>6)?stoull(argv[6]):1);
+		size_t topics=max<size_t>((argc>7)?stoul(argv[7]):1,1);
+		// Dictionary: nouns with their plural, adjectives with their feminine, verbs with a conjugated form, and stop words
+		ofstream dic(argv[1]);
+		if (!dic) throw runtime_error(string("Unable to open ")+argv[1]);
+		unordered_set<string> used(stop_words.begin(),stop_words.end());
+		vector<string> forms;
+		for (size_t i=0;i<lemmas;++i) {
+			auto lemma=new_word(random,used);
+			auto kind=random.real();
+			const char *pos=(kind<0.6)?"NOM":(kind<0.8)?"ADJ":"VER";
+			string inflected=lemma+((kind<0.6)?"s":(kind<0.8)?"e":"nt");
+			used.insert(inflected);
+			dic << lemma << '\t' << pos << '\t' << lemma << '\t' << random.integer(1,10000)/100.0 << '\n';
+			dic << inflected << '\t' << pos << '\t' << lemma << '\t' << random.integer(1,1000)/100.0 << '\n';
+			forms.push_back(lemma);
+			forms.push_back(inflected);
+		}
+		for (const auto &it:stop_words) dic << it << "\tPRE\t\t" << random.integer(1,100000)/100.0 << '\n';
+		if (!dic) throw runtime_error(string("Unable to write ")+argv[1]);
+		// Vocabulary of the text, sorted by decreasing frequency: the stop words first, then the forms of the dictionary in a random order, mixed with a few unknown words
+		vector<string> vocabulary(stop_words);
+		for (size_t i=forms.size();i>1;--i) swap(forms[i-1],forms[random.integer(0,i-1)]);
+		for (size_t i=0;i<forms.size();++i) {
+			vocabulary.push_back(move(forms[i]));
+			if (i%50==49) vocabulary.push_back(new_word(random,used));
+		}
+		// Each topic has its own vocabulary, made of the stop words and of a share of the other words, and its own Zipf law
+		vector<vector<string>> topic_vocabulary(topics,vector<string>(stop_words));
+		for (size_t i=stop_words.size();i<vocabulary.size();++i) topic_vocabulary[(i-stop_words.size())%topics].push_back(vocabulary[i]);
+		vector<vector<double>> cumulative(topics);
+		for (size_t t=0;t<topics;++t) {
+			double total=0.0;
+			for (size_t i=0;i<topic_vocabulary[t].size();++i) cumulative[t].push_back(total+=1.0/pow(double(i+1),skew));
+		}
+		// Text: sentences of 3 to 20 words drawn from the Zipf law of the current topic, the first word being capitalized. The topic changes after one sentence in ten on average
+		ofstream text(argv[2]);
+		if (!text) throw runtime_error(string("Unable to open ")+argv[2]);
+		size_t written=0;
+		size_t topic=0;
+		while (written<words) {
+			if (topics>1 && random.real()<0.1) topic=random.integer(0,topics-1);
+			const auto &weights=cumulative[topic];
+			auto length=min<size_t>(random.integer(3,20),words-written);
+			for (size_t i=0;i<length;++i) {
+				auto word=topic_vocabulary[topic][lower_bound(weights.begin(),weights.end(),random.real()*weights.back())-weights.begin()];
+				if (i==0 && word[0]>='a' && word[0]<='z') word[0]+='A'-'a';
+				if (i>0) text << ((random.real()<0.05)?", ":" ");
+				text << word;
+			}
+			text << ((random.real()<0.8)?". ":"\n");
+			written+=length;
+		}
+		text << '\n';
+		if (!text) throw runtime_error(string("Unable to write ")+argv[2]);
+	} catch (const exception &e) {
+		cerr << e.what() << '\n';
+		return 1;
+	}
+}
@@ -16,201 +16,897 @@
  * =====================================================================================
  */
 
-#include <locale>
-#include <codecvt>
 #include <iostream>
-#include <sstream>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <algorithm>
 #include <numeric>
 #include <iterator>
+#include <cmath>
+#include <functional>
+#include <unordered_set>
+#include <stdexcept>
+#include <cassert>
 #include "dictionary.h"
+#include "tokenizer.h"
+#include "thread_pool.h"
+#include "kernel.h"
 #include "graph.h"
 
 using namespace std;
 
-auto &global_facet=use_facet<ctype<wchar_t>>(locale());
-
 /*********************************************
  *           Utility functions               *
  *********************************************/
 /**
- * \brief Facet used to tokenize a string.
+ * \brief Perform a lookup of a word in the dictionary
  *
- * The facet is derived from the standard character type facet but considers all punctuation signs as whitespaces.
+ * This function returns the POS-tag of the word and the dictionary entry of its lemma, by performing a lookup in the dictionary through the cache. The node of the word is not set. It checks both the actual word and its lower-case version, with a single probe in the case-folded index of the dictionary. Words with less than 3 characters or without any ASCII letter are considered as stop words, without any lookup.
+ * \param w Original word, in UTF-8 encoding
+ * \param dic Dictionary
+ * \param cache Cache of the lookups
+ * \param entry Set to the entry of the dictionary matching the word, or -1, if it is not nullptr
+ * \return Word
  */
-struct Tokenizer_facet:ctype<wchar_t> {
+Word lookup_word(string_view w,const Dictionary &dic,Word_cache &cache,int32_t *entry=nullptr) {
+	if (entry!=nullptr) *entry=-1;
+	auto length=count_if(w.begin(),w.end(),[](char c){return (c&0xC0)!=0x80;});
+	if (length<3) return Word{w,Pos::STOP,-1,-1};
+	bool has_char=any_of(w.begin(),w.end(),[](char c){return (c>='a' && c<='z') || (c>='A' && c<='Z');});
+	if (!has_char) return Word{w,Pos::STOP,-1,-1};
+	auto res=cache.lookup(w,dic);
+	if (entry!=nullptr) *entry=res.entry;
+	return Word{w,res.pos,res.lemma,-1};
+}
+
+const char *solver_name(Solver solver) noexcept {
+	static const char *names[]={"jacobi","gauss-seidel","aitken","push"};
+	return names[int(solver)];
+}
 
-	/**
-	 * \brief Classification of a character
-	 */
-	bool do_is(mask m,char_type c) const {
-		if ((m & space) && (!iswalnum(c) || c==L'-')) return true;
-		return ctype::do_is(m,c);
+Solver solver_from_name(string_view name) {
+	for (auto solver:{Solver::JACOBI,Solver::GAUSS_SEIDEL,Solver::AITKEN,Solver::PUSH}) if (name==solver_name(solver)) return solver;
+	throw invalid_argument("Unknown solver "+string(name));
+}
+
+/*********************************************
+ *                 Graph                     *
+ *********************************************/
+void Graph::print(ostream &out) const {
+	for (int32_t i=0;i<size();++i) {
+		out << _lemmas[i] << "\t";
+		for (auto j=_offsets[i];j<_offsets[i+1];++j) if (_weights[j]>0) {
+			out << '(' << _lemmas[_neighbors[j]] << ',' << _weights[j] << ") ";
+		}
+		out << endl;
 	}
-};
+}
 
 /**
- * \brief Perform a lookup of a word in the dictionary
+ * \brief Hash a sequence of nodes
  *
- * This function returns a tuple with the original word, its POS-tag, its associated lemma, and a reference to the associated node in the graph by performing a lookup in the dictionary. It checks both the actual word and its lower-case version.
- * \param w Original word
- * \return Result tuple
+ * \param nodes Nodes
+ * \param size Number of nodes
+ * \return FNV-1a hash of the identifiers of the nodes, never equal to Flat_map::EMPTY
  */
-tuple<wstring,Pos,wstring,Node*> lookup_word(const wstring &w,const Dictionary &dic) {
-	if (w.size()<3) return make_tuple(w,Pos::STOP,L"",nullptr);
-	bool has_char=false;
-	for (const auto &ch:w) if (global_facet.is(ctype_base::alpha,ch)) {
-		has_char=true;
-		break;
-	}
-	if (!has_char) return make_tuple(w,Pos::STOP,L"",nullptr);
-	auto it=dic.lookup(w);
-	if (it!=dic.cend()) return make_tuple(w,it->pos,(it->pos==Pos::STOP)?L"":it->lemma,nullptr);
-	wstring lower;
-	transform(w.begin(),w.end(),back_inserter(lower),[](wchar_t c){return global_facet.tolower(c);});
-	it=dic.lookup(lower);
-	if (it!=dic.cend()) return make_tuple(w,it->pos,(it->pos==Pos::STOP)?L"":it->lemma,nullptr);
-	return make_tuple(w,Pos::UNKNOWN,w,nullptr);
+static uint64_t hash_nodes(const int32_t *nodes,uint32_t size) noexcept {
+	uint64_t h=14695981039346656037ull;
+	for (uint32_t i=0;i<size;++i) {
+		h^=uint32_t(nodes[i]);
+		h*=1099511628211ull;
+	}
+	return (h==Flat_map::EMPTY)?0:h;
 }
 
-/**
- * \brief Return a sentence from an input stream
- *
- * A sentence is delimited by either a newline character or a dot. The input stream is read until one of the following conditions is encountered:
- *   - the EOF bit or the bad bit of the fail bit is set
- *   - a dot is read ; the dot is not included in the resulting string
- *   - a newline character is read ; the newline character is not included in the resulting string
- * \param in Input stream
- * \return Sentence read from the input stream
- */
-wstring get_sentence(wistream &in) {
-	wostringstream oss;
-	wchar_t ch;
-	bool stop=false;
-	while (in && !stop) {
-		ch='\0';
-		in.get(ch);
-		if (in.fail() || in.bad() || ch==L'\n' || ch==L'.') {
-			stop=true;
-		} else oss.put(ch);
+size_t Graph::Run_hash::operator()(const Run &run) const noexcept {
+	auto h=hash_nodes(run.nodes,run.size);
+	return size_t(h^(h>>32));
+}
+
+int32_t Graph::node(const Word &word) {
+	auto id=_free_nodes.empty()?int32_t(_lemmas.size()):_free_nodes.back();
+	string_view lemma;
+	if (word.lemma!=-1) {
+		auto &res=_entry_ids[uint32_t(word.lemma)];
+		if (res!=0) return res-1;
+		res=id+1;
+		lemma=_dic.word(word.lemma);
+	} else {
+		auto it=_word_ids.find(word.text);
+		if (it!=_word_ids.end()) return it->second;
+		auto copy=static_cast<char*>(_arena->allocate(word.text.size(),1));
+		copy_n(word.text.data(),word.text.size(),copy);
+		lemma=string_view(copy,word.text.size());
+		_word_ids.emplace(lemma,id);
+	}
+	if (id<size()) {
+		// The node left the window of sentences, and has no edge left. It starts again from the score of the new nodes
+		_free_nodes.pop_back();
+		_lemmas[id]=lemma;
+		_node_entries[id]=word.lemma;
+		if (size_t(id)<_scores.size()) _scores[id]=1.0;
+		return id;
 	}
-	return oss.str();
+	_lemmas.push_back(lemma);
+	_occurrences.push_back(0);
+	if (_max_sentences>0) _node_entries.push_back(word.lemma);
+	return id;
 }
 
-/*********************************************
- *                  Node                     *
- *********************************************/
-void Node::print(wostream &out) const {
-	out << "(score=" << score << ",_lscore=" << _lscore << ",_total=" << _total;
-	for (const auto &it:edges) out << ",(" << it.first << "," << it.second << ")";
-	out << endl;
+void Graph::add_edge(int32_t a,int32_t b) {
+	auto key=edge_key(a,b);
+	++_edges[key];
+	if (_max_sentences>0) change_edge(key);
 }
 
-/*********************************************
- *                 Graph                     *
- *********************************************/
-void Graph::print(wostream &out) const {
-	for (auto &[key,node]:*this) {
-		wcout << key << "\t";
-		for (auto &[k,n]:node.edges) {
-			wcout << '(' << k << ',' << n << ") ";
-		}
-		wcout << endl;
-	}
-}
-
-void Graph::add_edge(const wstring &a,const wstring &b) noexcept {
-	auto &ela=(*this)[a];
-	auto &elb=(*this)[b];
-	ela.edges[b]=ela.edges[b]+1;
-	elb.edges[a]=elb.edges[a]+1;
-}
-
-void Graph::add_edge(const wstring &a,Node &na,const wstring &b,Node &nb) noexcept {
-	na.edges[b]=na.edges[b]+1;
-	nb.edges[a]=nb.edges[a]+1;
-}
-
-Graph::Graph(wistream &ifs,const Dictionary &dic,int window_size) {
-	ifs.imbue(locale(ifs.getloc(),new codecvt_utf8<wchar_t>));
-	while (ifs) {
-		wstring sentence=get_sentence(ifs);
-		wistringstream iss(sentence);
-		iss.imbue(locale(iss.getloc(),new codecvt_utf8<wchar_t>));
-		iss.imbue(locale(iss.getloc(),new Tokenizer_facet));
-		vector<wstring> tokens;
-		copy(istream_iterator<wstring,wchar_t>(iss),istream_iterator<wstring,wchar_t>(),back_inserter(tokens));
-		_tokens.emplace_back();
-		auto &t=_tokens.back();
-		t.reserve(tokens.size());
-		transform(tokens.begin(),tokens.end(),back_inserter(t),[&dic](const wstring &w){return lookup_word(w,dic);});
-		for (auto it=t.begin();it!=t.end();it++) if (get<1>(*it)!=Pos::STOP) {
-			auto &ela=(*this)[get<2>(*it)];
-			get<3>(*it)=&ela;
-			auto jt=it;
-			for (int i=0;i<window_size;++i) {
-				jt++;
-				while (jt!=t.end() && get<1>(*jt)==Pos::STOP) jt++;
-				if (jt!=t.end()) {
-					auto &elb=(*this)[get<2>(*jt)];
-					add_edge(get<2>(*it),ela,get<2>(*jt),elb);
-				} else break;
+void Graph::remove_edge(int32_t a,int32_t b) noexcept {
+	auto key=edge_key(a,b);
+	auto p=_edges.find(key);
+	// Only the edges of a sentence still in the window are removed, so the edge is always in the table
+	assert(p!=nullptr);
+	if (--*p==0) _edges.erase(key);
+	change_edge(key);
+}
+
+void Graph::change_edge(uint64_t key) {
+	if (_rebuild) return;
+	// Beyond the number of edges of the graph, building the CSR structure again is cheaper than patching it
+	if (_changed.size()>=max(_edges.size(),size_t(RANK_CHUNK))) {
+		_rebuild=true;
+		_changed.clear();
+		return;
+	}
+	_changed.push_back(key);
+}
+
+void Graph::release(int32_t a) {
+	if (_node_entries[a]!=-1) _entry_ids.erase(uint32_t(_node_entries[a])); else _word_ids.erase(_lemmas[a]);
+	_free_nodes.push_back(a);
+}
+
+void Graph::link(const vector<int32_t> &nodes,bool add) {
+	for (auto it=nodes.begin();it!=nodes.end();it++) if (*it!=-1) {
+		auto jt=it;
+		for (int i=0;i<_window_size;++i) {
+			jt++;
+			while (jt!=nodes.end() && *jt==-1) jt++;
+			if (jt==nodes.end()) break;
+			if (add) add_edge(*it,*jt); else remove_edge(*it,*jt);
+		}
+	}
+}
+
+void Graph::freeze() {
+	if (_frozen) return;
+	_frozen=true;
+	auto n=size();
+	// In a window of sentences, the rows of the changed edges are patched in place, unless new nodes were added or a row is full
+	if (!_rebuild && _offsets.size()==size_t(n)+1 && patch_rows()) {
+		_changed.clear();
+		return;
+	}
+	_changed.clear();
+	_offsets.assign(1,0);
+	_offsets.reserve(n+1);
+	_neighbors.clear();
+	_weights.clear();
+	_inv_total.assign(n,0.0);
+	// Degree of each node, an edge from a node to itself counting once with twice its weight
+	vector<int32_t> start(n+1,0);
+	_edges.for_each([&start](uint64_t key,int32_t) {
+		auto a=int32_t(key>>32),b=int32_t(uint32_t(key));
+		++start[a+1];
+		if (a!=b) ++start[b+1];
+	});
+	for (int32_t i=0;i<n;++i) start[i+1]+=start[i];
+	// Each row holds the neighbours of a node in the upper bits and the weights in the lower bits
+	vector<uint64_t> rows(start[n]);
+	vector<int32_t> fill(start.begin(),start.end()-1);
+	_edges.for_each([&](uint64_t key,int32_t w) {
+		auto a=int32_t(key>>32),b=int32_t(uint32_t(key));
+		if (a==b) rows[fill[a]++]=(uint64_t(uint32_t(a))<<32)|uint32_t(2*w);
+		else {
+			rows[fill[a]++]=(uint64_t(uint32_t(b))<<32)|uint32_t(w);
+			rows[fill[b]++]=(uint64_t(uint32_t(a))<<32)|uint32_t(w);
+		}
+	});
+	// In a window of sentences, each row ends with free edges, from the node to itself with a weight of 0, in which the edges of the next sentences are inserted
+	bool slack=(_max_sentences>0 && !_finished);
+	_rebuild=!slack;
+	auto capacity=[slack,&start](int32_t i) {
+		auto degree=start[i+1]-start[i];
+		return slack?degree+degree/8+ROW_SLACK:degree;
+	};
+	size_t edges=0;
+	for (int32_t i=0;i<n;++i) edges+=capacity(i);
+	_neighbors.resize(edges);
+	_weights.resize(edges);
+	if (slack) _degrees.resize(n);
+	int32_t k=0;
+	for (int32_t i=0;i<n;++i) {
+		// Neighbours are sorted by identifier to improve locality during the iterations
+		sort(rows.begin()+start[i],rows.begin()+start[i+1]);
+		int total=0;
+		for (auto j=start[i];j<start[i+1];++j,++k) {
+			_neighbors[k]=int32_t(rows[j]>>32);
+			_weights[k]=int32_t(uint32_t(rows[j]));
+			total+=_weights[k];
+		}
+		if (slack) {
+			_degrees[i]=start[i+1]-start[i];
+			auto end=_offsets.back()+capacity(i);
+			std::fill(_neighbors.begin()+k,_neighbors.begin()+end,i);
+			std::fill(_weights.begin()+k,_weights.begin()+end,0);
+			k=end;
+		}
+		if (total>0) _inv_total[i]=1.0/total;
+		_offsets.push_back(k);
+	}
+	if (_finished) _edges.clear();
+	_scores.resize(n,1.0);
+}
+
+bool Graph::set_edge(int32_t a,int32_t b,int32_t w) noexcept {
+	auto first=_offsets[a];
+	auto last=first+_degrees[a];
+	auto j=int32_t(lower_bound(_neighbors.begin()+first,_neighbors.begin()+last,b)-_neighbors.begin());
+	if (j<last && _neighbors[j]==b) {
+		if (w>0) {
+			_weights[j]=w;
+			return true;
+		}
+		// The following edges of the row are moved back, and the last one becomes free
+		copy(_neighbors.begin()+j+1,_neighbors.begin()+last,_neighbors.begin()+j);
+		copy(_weights.begin()+j+1,_weights.begin()+last,_weights.begin()+j);
+		_neighbors[last-1]=a;
+		_weights[last-1]=0;
+		--_degrees[a];
+		return true;
+	}
+	if (w==0) return true;
+	if (last==_offsets[a+1]) return false;
+	copy_backward(_neighbors.begin()+j,_neighbors.begin()+last,_neighbors.begin()+last+1);
+	copy_backward(_weights.begin()+j,_weights.begin()+last,_weights.begin()+last+1);
+	_neighbors[j]=b;
+	_weights[j]=w;
+	++_degrees[a];
+	return true;
+}
+
+bool Graph::patch_rows() {
+	// The weights are read from the table of edges, so that an edge which changed several times is set once to its final weight
+	vector<int32_t> rows;
+	rows.reserve(2*_changed.size());
+	for (auto key:_changed) {
+		auto a=int32_t(key>>32),b=int32_t(uint32_t(key));
+		auto p=_edges.find(key);
+		int32_t w=(p==nullptr)?0:*p;
+		if (a==b) {
+			if (!set_edge(a,a,2*w)) return false;
+		} else if (!set_edge(a,b,w) || !set_edge(b,a,w)) return false;
+		rows.push_back(a);
+		rows.push_back(b);
+	}
+	sort(rows.begin(),rows.end());
+	rows.erase(unique(rows.begin(),rows.end()),rows.end());
+	for (auto a:rows) {
+		auto total=accumulate(_weights.begin()+_offsets[a],_weights.begin()+_offsets[a]+_degrees[a],0);
+		_inv_total[a]=(total>0)?1.0/total:0.0;
+	}
+	return true;
+}
+
+Graph::Graph(const Dictionary &dic,int window_size,size_t max_sentences,Arena *arena,Profile *profile,Word_cache *cache):_dic(dic),_window_size(window_size),_own_arena(arena==nullptr?make_unique<Arena>():nullptr),_arena(arena==nullptr?_own_arena.get():arena),_profile(profile),_own_cache(cache==nullptr?make_unique<Word_cache>():nullptr),_cache(cache==nullptr?_own_cache.get():cache),_sentences(0),_finished(false),_frozen(false),_rebuild(true),_max_sentences(max_sentences),_run_threshold(1) {
+}
+
+Graph::Graph(istream &in,const Dictionary &dic,int window_size,Arena *arena,Profile *profile,Word_cache *cache):Graph(dic,window_size,0,arena,profile,cache) {
+	vector<char> buffer(65536);
+	while (in.read(buffer.data(),buffer.size()) || in.gcount()>0) append(string_view(buffer.data(),in.gcount()));
+	finish();
+}
+
+Graph::Graph(string_view text,const Dictionary &dic,int window_size,Arena *arena,Profile *profile,Word_cache *cache):Graph(dic,window_size,0,arena,profile,cache) {
+	// A word and its separator take about 6 bytes, and about half of the links between words are new edges. The table still grows if this is not enough
+	_edges.reserve(min(text.size()/12*size_t(window_size),size_t(1)<<20));
+	add_text(text,nullptr);
+	finish();
+}
+
+void Graph::append(string_view chunk,const function<void()> &on_sentence) {
+	if (_finished) throw logic_error("The whole text has already been appended to the graph");
+	// Sentences end with a dot or a newline, which are never part of a multi-byte sequence
+	auto last=chunk.find_last_of(".\n");
+	if (last==string_view::npos) {
+		_pending.append(chunk);
+		return;
+	}
+	auto first=chunk.find_first_of(".\n");
+	if (!_pending.empty()) {
+		_pending.append(chunk.substr(0,first+1));
+		add_text(_pending,on_sentence);
+		_pending.clear();
+		chunk.remove_prefix(first+1);
+		last-=first+1;
+		if (chunk.empty()) return;
+	}
+	add_text(chunk.substr(0,last+1),on_sentence);
+	_pending.assign(chunk.substr(last+1));
+}
+
+void Graph::finish(const function<void()> &on_sentence) {
+	if (_finished) return;
+	add_text(_pending,on_sentence);
+	_pending.clear();
+	_pending.shrink_to_fit();
+	// No word can be added any more, so that the tables of the nodes are released. Many small graphs may be kept at the same time to be ranked in a batch
+	_entry_ids.clear();
+	unordered_map<string_view,int32_t>().swap(_word_ids);
+	vector<Word>().swap(_sentence);
+	_run_index.clear();
+	_finished=true;
+	_frozen=false;
+	freeze();
+}
+
+void Graph::add_text(string_view text,const function<void()> &on_sentence) {
+	if (_profile!=nullptr) {
+		add_text_profiled(text,on_sentence);
+		return;
+	}
+	Tokenizer tokenizer(text);
+	string_view word;
+	for (;;) {
+		auto token=tokenizer.next(word);
+		if (token==Token::WORD) _sentence.push_back(lookup_word(word,_dic,*_cache));
+		else if (token==Token::SENTENCE) add_sentence(on_sentence);
+		else break;
+	}
+}
+
+void Graph::add_text_profiled(string_view text,const function<void()> &on_sentence) {
+	vector<pair<Token,string_view>> tokens;
+	vector<Word> words;
+	vector<int32_t> entries;
+	while (!text.empty()) {
+		auto end=(text.size()<=65536)?string_view::npos:text.find_first_of(".\n",65536);
+		auto slice=text.substr(0,(end==string_view::npos)?text.size():end+1);
+		text.remove_prefix(slice.size());
+		tokens.clear();
+		words.clear();
+		entries.clear();
+		{
+			Profile::Scope scope(_profile,Stage::TOKENIZE);
+			Tokenizer tokenizer(slice);
+			string_view word;
+			for (Token token;(token=tokenizer.next(word))!=Token::END;) tokens.emplace_back(token,word);
+		}
+		{
+			Profile::Scope scope(_profile,Stage::LOOKUP);
+			auto hits=_cache->hits();
+			auto misses=_cache->misses();
+			for (const auto &[token,word]:tokens) if (token==Token::WORD) {
+				entries.emplace_back();
+				words.push_back(lookup_word(word,_dic,*_cache,&entries.back()));
+			}
+			_profile->count(Counter::CACHE_HITS,_cache->hits()-hits);
+			_profile->count(Counter::CACHE_MISSES,_cache->misses()-misses);
+		}
+		_profile->count(Counter::TOKENS,words.size());
+		for (size_t i=0;i<words.size();++i) {
+			if (entries[i]!=-1) {
+				_profile->count(Counter::HITS);
+				if (_dic.word(entries[i])!=words[i].text) _profile->count(Counter::FOLDED);
+			} else if (words[i].pos==Pos::UNKNOWN) _profile->count(Counter::MISSES);
+		}
+		{
+			Profile::Scope scope(_profile,Stage::BUILD);
+			auto it=words.begin();
+			for (const auto &[token,word]:tokens) {
+				if (token==Token::WORD) _sentence.push_back(*it++);
+				else add_sentence(on_sentence);
 			}
 		}
 	}
 }
 
-vector<pair<wstring,double>> Graph::text_rank(int num_keywords,int num_iterations,double d) noexcept {
-	// Calculate and store the total weight of edges per node, and initialize scores of nodes to 1
-	for (auto &it:*this) {
-		it.second.score=1.0;
-		it.second._total=accumulate(it.second.edges.begin(),it.second.edges.end(),0,[](const auto &a,const auto &b){return a+b.second;});
-	}
-	// Main loop of the text-rank algorithm. Iterate to evaluate the scores of each node
-	for (int i=0;i<num_iterations;++i) {
-		for (auto &it:*this) it.second._lscore=it.second.score;
-		for (auto &it:*this) {
-			it.second.score=(1-d)+d*accumulate(it.second.edges.begin(),it.second.edges.end(),0.0,[=](const auto &a,const auto &b) {const auto n=find(b.first);if (n!=cend()) return a+b.second*n->second._lscore/n->second._total; else return a;});
-		}
-	}
-	// Store the words and their associated node in the graph in a vector
-	std::vector<std::pair<std::wstring,Node*>> keywords;
-	transform(begin(),end(),back_inserter(keywords),[](auto &a){return make_pair(a.first,&(a.second));});
-	// Partially sort the vector for the first num_keywords terms
-	auto middle=keywords.begin();
-	if (num_keywords>int(keywords.size())) num_keywords=keywords.size();
-	advance(middle,num_keywords);
-	partial_sort(keywords.begin(),middle,keywords.end(),[](const auto &a,const auto &b){return a.second->score>b.second->score;});
-	// Generate a vector with the keywords and their scores
-	for (auto it=keywords.begin();it!=middle;it++) it->second->keyword=true;
-	vector<pair<wstring,double>> res;
-	transform(keywords.begin(),middle,back_inserter(res),[](const auto &a){return make_pair(a.first,a.second->score);});
-	// Go once again through the text to find if two or more consecutive words are keywords. In that case, add a multiple-word keyword to the result vector by merging the keywords and summing up ther scores
-	for (auto &it:_tokens) {
-		auto jt=it.begin();
-		while (jt!=it.end()) {
-			if (get<3>(*jt)!=nullptr && get<3>(*jt)->keyword) {
-				auto kt=jt;
-				do {
-					kt++;
-				} while (kt!=it.end() && get<3>(*kt)!=nullptr && get<3>(*kt)->keyword);
-				if (distance(jt,kt)>1) {
-					wostringstream oss;
-					transform(jt,kt,ostream_iterator<wstring,wchar_t>(oss,L" "),[](const auto &a){return get<2>(a);});
-					auto kw=oss.str();
-					kw.erase(kw.end()-1);
-					if (find_if(res.cbegin(),res.cend(),[&kw](const auto &a) {return get<0>(a)==kw;})==res.cend()) res.push_back(make_pair(kw,accumulate(jt,kt,0.0,[](const auto &a,const auto &b) {return a+get<3>(b)->score;})));
+void Graph::add_sentence(const function<void()> &on_sentence) {
+	if (_sentence.empty()) return;
+	vector<int32_t> nodes;
+	nodes.reserve(_sentence.size());
+	for (auto &it:_sentence) {
+		if (it.pos!=Pos::STOP) {
+			it.node=node(it);
+			++_occurrences[it.node];
+		}
+		nodes.push_back(it.node);
+	}
+	_sentence.clear();
+	link(nodes,true);
+	if (_max_sentences==0) {
+		// Record the maximal runs of significant words
+		for (auto it=nodes.cbegin();it!=nodes.cend();) {
+			if (*it==-1) {
+				++it;
+				continue;
+			}
+			auto jt=find(it,nodes.cend(),-1);
+			if (distance(it,jt)>1) add_run(&*it,&*it+distance(it,jt));
+			it=jt;
+		}
+	} else {
+		// The sentence is kept in the window, and the oldest one leaves it
+		_history.push_back(move(nodes));
+		if (_history.size()>_max_sentences) {
+			const auto &old=_history.front();
+			link(old,false);
+			for (auto it:old) if (it!=-1 && --_occurrences[it]==0) release(it);
+			_history.pop_front();
+		}
+	}
+	++_sentences;
+	_frozen=false;
+	if (on_sentence) on_sentence();
+}
+
+void Graph::add_run(const int32_t *first,const int32_t *last) {
+	auto n=uint32_t(last-first);
+	auto &offset=_run_index[hash_nodes(first,n)];
+	if (offset>0) {
+		// The stored run is followed by -1, which ends the comparison if it is shorter. Runs whose hashes collide are stored without being indexed
+		if (equal(first,last,_runs.begin()+(offset-1)) && _runs[offset-1+n]==-1) return;
+	} else offset=int32_t(_runs.size())+1;
+	_runs.insert(_runs.end(),first,last);
+	_runs.push_back(-1);
+	if (_runs.size()>max(RUN_NODES_MIN,RUN_NODES_PER_NODE*size_t(size()))) compact_runs();
+}
+
+void Graph::compact_runs() {
+	// Number of times each number of occurrences appears among the nodes of the runs
+	vector<size_t> counts;
+	for (auto a:_runs) if (a!=-1) {
+		auto k=size_t(_occurrences[a]);
+		if (k>=counts.size()) counts.resize(k+1);
+		++counts[k];
+	}
+	// The nodes with the fewest occurrences are cut until at most a third of the budget is kept, since the parts of at least two nodes add at most half as many -1
+	auto budget=max(RUN_NODES_MIN,RUN_NODES_PER_NODE*size_t(size()));
+	size_t kept=0;
+	for (auto k:counts) kept+=k;
+	auto threshold=size_t(_run_threshold)+1;
+	for (size_t k=0;k<threshold && k<counts.size();++k) kept-=counts[k];
+	for (;threshold<counts.size() && kept>budget/3;++threshold) kept-=counts[threshold];
+	_run_threshold=int32_t(threshold);
+	_run_index.clear();
+	auto keep=[this](int32_t a){return a!=-1 && _occurrences[a]>=_run_threshold;};
+	// The parts are written over the runs, before the position where they are read. The last element of the runs is -1, which ends each part
+	size_t out=0;
+	for (size_t i=0;i<_runs.size();) {
+		if (!keep(_runs[i])) {
+			++i;
+			continue;
+		}
+		auto j=i;
+		while (keep(_runs[j])) ++j;
+		auto n=uint32_t(j-i);
+		if (n>1) {
+			auto &offset=_run_index[hash_nodes(&_runs[i],n)];
+			if (offset==0 || !equal(_runs.begin()+i,_runs.begin()+j,_runs.begin()+(offset-1)) || _runs[offset-1+n]!=-1) {
+				if (offset==0) offset=int32_t(out)+1;
+				copy(_runs.begin()+i,_runs.begin()+j,_runs.begin()+out);
+				out+=n;
+				_runs[out++]=-1;
+			}
+		}
+		i=j;
+	}
+	_runs.resize(out);
+}
+
+template<class T> vector<T> Graph::initial_scores(const Rank_parameters &parameters) const {
+	auto n=size();
+	T d=T(parameters.damping);
+	vector<T> scores(n,T(1));
+	if (parameters.warm_start) {
+		// At the fixed point, the mean score of the nodes with edges is 1. The previous scores are scaled to that mean, otherwise their total converges only by a factor d at each iteration
+		double total=0.0;
+		int32_t linked=0;
+		for (int32_t u=0;u<n;++u) if (_inv_total[u]>0) {
+			total+=_scores[u];
+			++linked;
+		}
+		double scale=(total>0)?linked/total:1.0;
+		for (int32_t u=0;u<n;++u) scores[u]=(_inv_total[u]>0)?T(_scores[u]*scale):T(1-d);
+	}
+	return scores;
+}
+
+template<class T> void Graph::iterate(const Rank_parameters &parameters,Gather_kernel<T> kernel,Ranking &res) noexcept {
+	auto n=size();
+	T d=T(parameters.damping);
+	// Main loop of the text-rank algorithm. Iterate to evaluate the scores of each node. The contribution of each node to its neighbours is its previous score divided by the total weight of its edges
+	// Nodes are processed by chunks of fixed size, possibly in parallel. The residual of each chunk is stored apart and the residuals are combined in the order of the chunks, so that the result does not depend on the number of threads
+	auto scores=initial_scores<T>(parameters);
+	vector<T> contrib(n);
+	vector<T> inv_total(_inv_total.begin(),_inv_total.end());
+	int32_t chunks=(n+RANK_CHUNK-1)/RANK_CHUNK;
+	vector<double> partial(chunks);
+	vector<vector<T>> sums(chunks);
+	// The function object of the pool is only built when the chunks run in parallel, so that the small graphs do not call the allocator at each iteration
+	auto for_chunks=[&](const auto &fn) {
+		if (parameters.pool!=nullptr && chunks>1) parameters.pool->parallel_for(chunks,fn);
+		else for (int32_t c=0;c<chunks;++c) fn(c);
+	};
+	while (res.iterations<parameters.max_iterations) {
+		for_chunks([&](int c) {
+			auto end=min(n,(c+1)*RANK_CHUNK);
+			for (int32_t u=c*RANK_CHUNK;u<end;++u) contrib[u]=scores[u]*inv_total[u];
+		});
+		for_chunks([&](int c) {
+			auto begin=c*RANK_CHUNK;
+			auto end=min(n,begin+RANK_CHUNK);
+			auto &sum=sums[c];
+			sum.resize(end-begin);
+			kernel(_offsets.data(),_neighbors.data(),_weights.data(),contrib.data(),sum.data(),begin,end);
+			double residual=0.0;
+			for (int32_t v=begin;v<end;++v) {
+				T score=(1-d)+d*sum[v-begin];
+				double delta=fabs(double(score)-double(scores[v]));
+				if (parameters.norm==Norm::L1) residual+=delta; else residual=max(residual,delta);
+				scores[v]=score;
+			}
+			partial[c]=residual;
+		});
+		double residual=0.0;
+		for (auto it:partial) if (parameters.norm==Norm::L1) residual+=it; else residual=max(residual,it);
+		++res.iterations;
+		res.residual=residual;
+		res.traversals+=_neighbors.size();
+		if (residual<=parameters.tolerance) break;
+	}
+	_scores.assign(scores.begin(),scores.end());
+}
+
+void Graph::iterate_gauss_seidel(const Rank_parameters &parameters,Ranking &res) {
+	auto n=size();
+	double d=parameters.damping;
+	auto scores=initial_scores<double>(parameters);
+	vector<double> contrib(n),previous(n);
+	for (int32_t u=0;u<n;++u) contrib[u]=scores[u]*_inv_total[u];
+	// At the fixed point, the total score of the nodes with edges is their number. The power iteration keeps that total, but a sweep which uses the new scores as soon as they are computed does not, and the error on the total would only decrease by a factor d at each sweep. It is removed after each sweep by adding the missing total to the nodes in proportion to the total weights of their edges, which is the direction in which it would slowly spread
+	double linked=0.0,weights=0.0;
+	for (int32_t u=0;u<n;++u) if (_inv_total[u]>0) {
+		linked+=1;
+		weights+=1/_inv_total[u];
+	}
+	while (res.iterations<parameters.max_iterations) {
+		previous=scores;
+		double total=0.0;
+		for (int32_t v=0;v<n;++v) {
+			double sum=0.0;
+			for (auto j=_offsets[v];j<_offsets[v+1];++j) sum+=_weights[j]*contrib[_neighbors[j]];
+			scores[v]=(1-d)+d*sum;
+			contrib[v]=scores[v]*_inv_total[v];
+			if (_inv_total[v]>0) total+=scores[v];
+		}
+		double correction=(weights>0)?(linked-total)/weights:0.0;
+		double residual=0.0;
+		for (int32_t v=0;v<n;++v) {
+			if (_inv_total[v]>0) {
+				scores[v]+=correction/_inv_total[v];
+				contrib[v]+=correction;
+			}
+			double delta=fabs(scores[v]-previous[v]);
+			if (parameters.norm==Norm::L1) residual+=delta; else residual=max(residual,delta);
+		}
+		++res.iterations;
+		res.residual=residual;
+		res.traversals+=_neighbors.size();
+		if (residual<=parameters.tolerance) break;
+	}
+	_scores=move(scores);
+}
+
+void Graph::iterate_aitken(const Rank_parameters &parameters,Ranking &res) {
+	auto n=size();
+	double d=parameters.damping;
+	auto scores=initial_scores<double>(parameters);
+	vector<double> contrib(n),previous(n),change(n,0.0);
+	int since=0;
+	double last_ratio=0.0;
+	while (res.iterations<parameters.max_iterations) {
+		for (int32_t u=0;u<n;++u) contrib[u]=scores[u]*_inv_total[u];
+		swap(previous,scores);
+		double residual=0.0,product=0.0,square=0.0;
+		for (int32_t v=0;v<n;++v) {
+			double sum=0.0;
+			for (auto j=_offsets[v];j<_offsets[v+1];++j) sum+=_weights[j]*contrib[_neighbors[j]];
+			scores[v]=(1-d)+d*sum;
+			double delta=scores[v]-previous[v];
+			if (parameters.norm==Norm::L1) residual+=fabs(delta); else residual=max(residual,fabs(delta));
+			product+=delta*change[v];
+			square+=change[v]*change[v];
+			change[v]=delta;
+		}
+		++res.iterations;
+		res.residual=residual;
+		res.traversals+=_neighbors.size();
+		if (residual<=parameters.tolerance) break;
+		// Once the error is dominated by its slowest mode, each change of the scores is the previous one multiplied by a constant ratio, and the sum of the next changes, which is the remaining error, is given by the Aitken delta-squared process. The ratio is measured by projecting the last change on the previous one. When the changes decrease fast, or with a ratio which is not stable yet, the extrapolation would only add noise
+		double ratio=(square>0)?product/square:0.0;
+		bool stable=(fabs(ratio)>=AITKEN_RATIO && fabs(ratio)<1 && fabs(ratio-last_ratio)<=0.05*fabs(ratio));
+		last_ratio=ratio;
+		if (++since>=AITKEN_PERIOD && stable) {
+			double factor=ratio/(1-ratio);
+			for (int32_t v=0;v<n;++v) scores[v]+=factor*change[v];
+			since=0;
+		}
+	}
+	_scores=move(scores);
+}
+
+void Graph::iterate_push(const Rank_parameters &parameters,Ranking &res) {
+	auto n=size();
+	double d=parameters.damping;
+	// The scores are the solution of x=(1-d)+d*M*x. The residual of the current scores, r=(1-d)+d*M*x-x, is the change the next Jacobi iteration would make. Pushing the residual of a node adds it to its score, and spreads it to the residuals of its neighbours
+	// The scores start from the same values as the power iteration, whose total is already the one of the fixed point, so that the residuals sum to zero and the pushes only have to move scores between the nodes
+	auto scores=initial_scores<double>(parameters);
+	vector<double> residuals(n);
+	for (int32_t v=0;v<n;++v) {
+		double sum=0.0;
+		for (auto j=_offsets[v];j<_offsets[v+1];++j) sum+=_weights[j]*scores[_neighbors[j]]*_inv_total[_neighbors[j]];
+		residuals[v]=(1-d)+d*sum-scores[v];
+	}
+	res.traversals+=_neighbors.size();
+	// Only the residuals above the threshold are pushed, so that the norm of the residuals ends up lower than the tolerance
+	double threshold=(parameters.norm==Norm::L1 && n>0)?parameters.tolerance/n:parameters.tolerance;
+	// Nodes to process, in a circular queue where each node appears at most once
+	vector<int32_t> queue(n);
+	vector<char> queued(n,0);
+	size_t head=0,count=0;
+	auto enqueue=[&](int32_t v) {
+		if (queued[v] || fabs(residuals[v])<=threshold) return;
+		queue[(head+count)%n]=v;
+		++count;
+		queued[v]=1;
+	};
+	for (int32_t v=0;v<n;++v) enqueue(v);
+	// With the L1 norm, the pushes stop as soon as the norm of the residuals is lower than the tolerance, which is the criterion of the other solvers, even if some residuals are still above the threshold
+	bool l1=(parameters.norm==Norm::L1);
+	double norm=0.0;
+	for (auto it:residuals) norm+=fabs(it);
+	uint64_t pushes=0;
+	uint64_t limit=uint64_t(max(parameters.max_iterations,0))*n;
+	while (count>0 && pushes<limit && !(l1 && norm<=parameters.tolerance)) {
+		auto u=queue[head];
+		head=(head+1)%n;
+		--count;
+		queued[u]=0;
+		double pushed=residuals[u];
+		residuals[u]=0.0;
+		norm-=fabs(pushed);
+		scores[u]+=pushed;
+		++pushes;
+		if (_inv_total[u]>0) {
+			double share=d*pushed*_inv_total[u];
+			for (auto j=_offsets[u];j<_offsets[u+1];++j) {
+				auto &r=residuals[_neighbors[j]];
+				norm-=fabs(r);
+				r+=share*_weights[j];
+				norm+=fabs(r);
+				enqueue(_neighbors[j]);
+			}
+			res.traversals+=_offsets[u+1]-_offsets[u];
+		}
+	}
+	res.iterations=(n>0)?int((pushes+n-1)/n):0;
+	res.residual=0.0;
+	for (auto it:residuals) if (parameters.norm==Norm::L1) res.residual+=fabs(it); else res.residual=max(res.residual,fabs(it));
+	_scores=move(scores);
+}
+
+template<class T> void Graph::iterate_batch(const vector<Graph*> &graphs,const vector<Rank_parameters> &parameters,const vector<size_t> &members,Gather_kernel<T> kernel,vector<Ranking> &res) {
+	// Pack the CSR structures of the graphs in a single block-diagonal matrix. The nodes of the b-th member are [first[b],first[b+1])
+	size_t blocks=members.size();
+	vector<int32_t> first(blocks+1,0);
+	for (size_t b=0;b<blocks;++b) first[b+1]=first[b]+graphs[members[b]]->size();
+	int32_t n=first[blocks];
+	int32_t total=0;
+	for (auto i:members) total+=int32_t(graphs[i]->_neighbors.size());
+	vector<int32_t> offsets(n+1,0),neighbors(total),weights(total);
+	vector<T> inv_total(n),scores(n,T(1)),contrib(n),sums(n);
+	int32_t edges=0;
+	for (size_t b=0;b<blocks;++b) {
+		const auto &graph=*graphs[members[b]];
+		int32_t base=first[b];
+		for (int32_t i=0;i<graph.size();++i) offsets[base+i+1]=edges+graph._offsets[i+1];
+		for (size_t j=0;j<graph._neighbors.size();++j) neighbors[edges+j]=base+graph._neighbors[j];
+		copy(graph._weights.begin(),graph._weights.end(),weights.begin()+edges);
+		edges+=int32_t(graph._neighbors.size());
+		copy(graph._inv_total.begin(),graph._inv_total.end(),inv_total.begin()+base);
+		if (parameters[members[b]].warm_start) {
+			auto initial=graph.initial_scores<T>(parameters[members[b]]);
+			copy(initial.begin(),initial.end(),scores.begin()+base);
+		}
+	}
+	// Blocks which did not converge yet, in increasing order so that consecutive blocks are processed by a single call to the kernel
+	vector<size_t> active;
+	auto store=[&](size_t b) {graphs[members[b]]->_scores.assign(scores.begin()+first[b],scores.begin()+first[b+1]);};
+	for (size_t b=0;b<blocks;++b) if (parameters[members[b]].max_iterations>0) active.push_back(b); else store(b);
+	for (int32_t u=0;u<n;++u) contrib[u]=scores[u]*inv_total[u];
+	while (!active.empty()) {
+		for (size_t i=0;i<active.size();) {
+			auto j=i+1;
+			while (j<active.size() && active[j]==active[j-1]+1) ++j;
+			int32_t begin=first[active[i]],end=first[active[j-1]+1];
+			kernel(offsets.data(),neighbors.data(),weights.data(),contrib.data(),sums.data()+begin,begin,end);
+			i=j;
+		}
+		// The contributions of the next iteration are computed with the new scores, which saves a pass over the nodes
+		size_t kept=0;
+		for (auto b:active) {
+			const auto &param=parameters[members[b]];
+			auto &ranking=res[members[b]];
+			T d=T(param.damping);
+			bool l1=(param.norm==Norm::L1);
+			int32_t last=first[b+1];
+			// The residual is combined by chunks of nodes in the same order as by the iterations of a single graph, so that it is identical
+			double residual=0.0;
+			for (int32_t chunk=first[b];chunk<last;chunk+=RANK_CHUNK) {
+				double partial=0.0;
+				auto end=min(last,chunk+RANK_CHUNK);
+				for (int32_t v=chunk;v<end;++v) {
+					T score=(1-d)+d*sums[v];
+					double delta=fabs(double(score)-double(scores[v]));
+					if (l1) partial+=delta; else partial=max(partial,delta);
+					scores[v]=score;
+					contrib[v]=score*inv_total[v];
 				}
+				if (l1) residual+=partial; else residual=max(residual,partial);
+			}
+			++ranking.iterations;
+			ranking.residual=residual;
+			ranking.traversals+=offsets[last]-offsets[first[b]];
+			if (residual<=param.tolerance || ranking.iterations>=param.max_iterations) store(b);
+			else active[kept++]=b;
+		}
+		active.resize(kept);
+	}
+}
+
+void Graph::iterate_solver(const Rank_parameters &parameters,Ranking &res) {
+	if (parameters.solver==Solver::GAUSS_SEIDEL) iterate_gauss_seidel(parameters,res);
+	else if (parameters.solver==Solver::AITKEN) iterate_aitken(parameters,res);
+	else if (parameters.solver==Solver::PUSH) iterate_push(parameters,res);
+	else if (parameters.precision==Precision::FLOAT) iterate<float>(parameters,gather_kernel_float(parameters.kernel),res);
+	else iterate<double>(parameters,gather_kernel_double(parameters.kernel),res);
+}
+
+Ranking Graph::text_rank(const Rank_parameters &parameters) {
+	{
+		Profile::Scope scope(_profile,Stage::BUILD);
+		freeze();
+	}
+	Ranking res;
+	{
+		Profile::Scope scope(_profile,Stage::RANK);
+		iterate_solver(parameters,res);
+	}
+	assemble(parameters.num_keywords,res);
+	return res;
+}
+
+vector<Ranking> Graph::text_rank_batch(const vector<Graph*> &graphs,const vector<Rank_parameters> &parameters) {
+	if (graphs.size()!=parameters.size()) throw invalid_argument("There must be one set of parameters for each graph");
+	vector<Ranking> res(graphs.size());
+	for (auto graph:graphs) {
+		Profile::Scope scope(graph->_profile,Stage::BUILD);
+		graph->freeze();
+	}
+	// A graph which is alone, which fills a matrix by itself or whose iterations are shared with a pool of threads gains nothing from the packing
+	vector<bool> alone(graphs.size());
+	for (size_t i=0;i<graphs.size();++i) {
+		const auto &param=parameters[i];
+		alone[i]=(graphs.size()==1 || param.solver!=Solver::JACOBI || param.pool!=nullptr || graphs[i]->_neighbors.size()>size_t(BATCH_EDGES));
+		if (!alone[i]) continue;
+		Profile::Scope scope(graphs[i]->_profile,Stage::RANK);
+		graphs[i]->iterate_solver(param,res[i]);
+	}
+	// The time of the iterations of a matrix is shared between the profiles of its graphs in proportion to the number of edges they read
+	auto rank=[&](const vector<size_t> &members,auto kernel) {
+		auto wall=chrono::steady_clock::now();
+		auto cpu=Profile::cpu_time();
+		iterate_batch(graphs,parameters,members,kernel,res);
+		double elapsed=chrono::duration<double>(chrono::steady_clock::now()-wall).count();
+		cpu=Profile::cpu_time()-cpu;
+		uint64_t traversals=0;
+		for (auto i:members) traversals+=res[i].traversals;
+		for (auto i:members) if (graphs[i]->_profile!=nullptr) {
+			double share=(traversals>0)?double(res[i].traversals)/traversals:1.0/members.size();
+			graphs[i]->_profile->add(Stage::RANK,elapsed*share,cpu*share);
+		}
+	};
+	for (auto precision:{Precision::DOUBLE,Precision::FLOAT}) for (auto kernel:{Kernel::AUTO,Kernel::SCALAR,Kernel::AVX2,Kernel::AVX512}) {
+		vector<size_t> members;
+		int32_t edges=0;
+		auto flush=[&]() {
+			if (members.empty()) return;
+			if (precision==Precision::FLOAT) rank(members,gather_kernel_float(kernel)); else rank(members,gather_kernel_double(kernel));
+			members.clear();
+			edges=0;
+		};
+		for (size_t i=0;i<graphs.size();++i) {
+			const auto &param=parameters[i];
+			if (alone[i] || param.precision!=precision || param.kernel!=kernel) continue;
+			auto size=int32_t(graphs[i]->_neighbors.size());
+			if (edges>0 && size>BATCH_EDGES-edges) flush();
+			members.push_back(i);
+			edges+=size;
+		}
+		flush();
+	}
+	for (size_t i=0;i<graphs.size();++i) graphs[i]->assemble(parameters[i].num_keywords,res[i]);
+	return res;
+}
+
+void Graph::assemble(int num_keywords,Ranking &res) const {
+	auto n=size();
+	if (_profile!=nullptr) {
+		// Each non-directional edge is stored in the rows of both nodes, except the loops
+		uint64_t edges=0;
+		for (int32_t i=0;i<n;++i) for (auto j=_offsets[i];j<_offsets[i+1];++j) if (_weights[j]>0 && _neighbors[j]>=i) ++edges;
+		_profile->count(Counter::ITERATIONS,res.iterations);
+		_profile->count(Counter::TRAVERSALS,res.traversals);
+		_profile->set(Counter::SENTENCES,_sentences);
+		_profile->set(Counter::NODES,n);
+		_profile->set(Counter::EDGES,edges);
+	}
+	Profile::Scope scope(_profile,Stage::PHRASES);
+	// Partially sort the nodes for the first num_keywords terms. Only the nodes with words in the graph may be keywords
+	vector<int32_t> keywords;
+	keywords.reserve(n);
+	for (int32_t i=0;i<n;++i) if (_occurrences[i]>0) keywords.push_back(i);
+	num_keywords=clamp(num_keywords,0,int(keywords.size()));
+	auto middle=keywords.begin()+num_keywords;
+	partial_sort(keywords.begin(),middle,keywords.end(),[this](int32_t a,int32_t b){return _scores[a]>_scores[b] || (_scores[a]==_scores[b] && a<b);});
+	// Candidates of the result, as sequences of nodes. The strings are only built for the final keywords
+	struct Candidate {
+		Run run; 	//!< Nodes of the keyword
+		double score; 	//!< Score of the keyword
+	};
+	vector<Candidate> candidates;
+	vector<char> keyword(n,0);
+	for (auto it=keywords.begin();it!=middle;it++) {
+		keyword[*it]=1;
+		candidates.push_back(Candidate{Run{&*it,1},_scores[*it]});
+	}
+	// Go through the runs of significant words to find if two or more consecutive words are keywords. In that case, add a multiple-word keyword to the candidates, whose score is the sum of the scores of its words. Repeated phrases are detected by hashing their nodes
+	unordered_set<Run,Run_hash> phrases;
+	auto is_keyword=[&keyword](int32_t a){return a!=-1 && keyword[a];};
+	auto assemble=[&](const int32_t *first,const int32_t *last) {
+		auto jt=first;
+		while (jt!=last) {
+			if (is_keyword(*jt)) {
+				auto kt=find_if_not(jt,last,is_keyword);
+				Run phrase{jt,uint32_t(kt-jt)};
+				if (phrase.size>1 && phrases.insert(phrase).second) candidates.push_back(Candidate{phrase,accumulate(jt,kt,0.0,[this](double a,int32_t b) {return a+_scores[b];})});
 				jt=kt;
 			} else jt++;
 		}
+	};
+	if (_max_sentences==0) assemble(_runs.data(),_runs.data()+_runs.size());
+	else for (const auto &sentence:_history) assemble(sentence.data(),sentence.data()+sentence.size());
+	// Sort again with the new multi-word keywords, and build the strings of the first num_keywords ones
+	sort(candidates.begin(),candidates.end(),[](const auto &a,const auto &b){return a.score>b.score;});
+	candidates.resize(min(candidates.size(),size_t(num_keywords)));
+	res.reserve(candidates.size());
+	for (const auto &it:candidates) {
+		string kw(_lemmas[it.run.nodes[0]]);
+		for (uint32_t i=1;i<it.run.size;++i) {
+			kw.push_back(' ');
+			kw.append(_lemmas[it.run.nodes[i]]);
+		}
+		res.emplace_back(move(kw),it.score);
 	}
-	// Sort again with the new multi-word keywords
-	sort(res.begin(),res.end(),[](const auto &a,const auto &b){return a.second>b.second;});
-	res.erase(res.begin()+num_keywords,res.end());
-	// Return the result
-	return res;
 }
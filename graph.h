@@ -22,66 +22,262 @@
 
 #include <iostream>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <algorithm>
 #include <utility>
-#include <tuple>
 #include "dictionary.h"
+#include "kernel.h"
+#include "arena.h"
+#include "profile.h"
+#include "word_cache.h"
+#include "flat_map.h"
+
+class Thread_pool;
+
+/**
+ * \brief Number of nodes processed together by a thread during an iteration of TextRank
+ */
+constexpr int32_t RANK_CHUNK=4096;
+
+/**
+ * \brief Largest number of edges of the graphs packed in a single block-diagonal matrix by Graph::text_rank_batch, so that the matrix and the scores stay in the cache of the processor
+ */
+constexpr int32_t BATCH_EDGES=1<<16;
+
+/**
+ * \brief Number of nodes of the distinct runs kept for the multi-word keywords for each node of the graph. Beyond this budget, the runs are cut at their rarest nodes, so that their memory is bounded by the vocabulary of the text and not by its length
+ */
+constexpr std::size_t RUN_NODES_PER_NODE=8;
+
+/**
+ * \brief Smallest budget of the nodes of the distinct runs, so that the runs of short texts are never cut
+ */
+constexpr std::size_t RUN_NODES_MIN=1<<16;
+
+/**
+ * \brief Number of free edges at the end of each row of the CSR structure, besides an eighth of its degree, when the graph is restricted to a window of sentences. The edges of the next sentences are then inserted in place in their rows, which are only built again from the table of edges when one of them is full
+ */
+constexpr int32_t ROW_SLACK=2;
+
+/**
+ * \brief Number of iterations between two extrapolations of the scores by the Aitken solver. The extrapolation needs three consecutive iterates, and is only worth it once the error is dominated by its slowest mode
+ */
+constexpr int AITKEN_PERIOD=3;
+
+/**
+ * \brief Smallest ratio between two consecutive changes of the scores for which the Aitken solver extrapolates them
+ */
+constexpr double AITKEN_RATIO=0.5;
+
+/**
+ * \brief Norm used to measure the change of the scores between two iterations
+ */
+enum class Norm {
+	L1, 	//!< Sum of the absolute changes of all the scores
+	LINF 	//!< Largest absolute change of a score
+};
 
 /**
- * \brief Node of the network
+ * \brief Method solving the equations of the scores of TextRank
  *
- * A node holds a word (or lemma), and a list of edges which link the node to other nodes in the graph.
+ * All the solvers converge to the same scores. They differ by the number of edges read before the residual is lower than the tolerance.
  */
-class Node {
-	public:
-		friend class Graph;
-		double score; 	//!< Score of the node
-		bool keyword; 	//!< Variable reserved to tell if the word is a keyword
-		std::unordered_map<std::wstring,int> edges; 	//!< Edges to other nodes, together with their weight
+enum class Solver {
+	JACOBI, 	//!< Power iteration: each iteration computes all the scores from the scores of the previous one
+	GAUSS_SEIDEL, 	//!< Each iteration updates the scores in place, so that each node already uses the new scores of the nodes before it
+	AITKEN, 	//!< Power iteration whose scores are extrapolated with the Aitken delta-squared process once their changes decrease with a stable ratio
+	PUSH 	//!< Gauss-Southwell method: the residual of each node is pushed to its neighbours, and only the nodes whose residual exceeds a threshold are processed. It only reads fewer edges than the power iteration when the residuals are concentrated on a few nodes
+};
 
-		Node():score(1.0),keyword(false) {}
+/**
+ * \brief Name of a solver
+ *
+ * \param solver Solver
+ * \return Name of the solver, as accepted by solver_from_name
+ */
+const char *solver_name(Solver solver) noexcept;
 
-		/**
-		 * \brief Print the whole node on an output stream
-		 *
-		 * This method is mainly for debug purposes. It prints the node in a readable way on an output stream.
-		 * \param out Output stream
-		 */
-		void print(std::wostream &out) const;
-	private:
-		double _lscore; 	//!< Previous score of the node
-		int _total; 	//!< Sum of the weights of edges from this node
+/**
+ * \brief Solver with a given name
+ *
+ * \param name Name of the solver, either "jacobi", "gauss-seidel", "aitken" or "push"
+ * \return Solver
+ * \throw std::invalid_argument if the name is unknown
+ */
+Solver solver_from_name(std::string_view name);
+
+/**
+ * \brief Parameters of the TextRank algorithm
+ */
+struct Rank_parameters {
+	int num_keywords=10; 	//!< Number of keywords expected
+	int max_iterations=20; 	//!< Maximal number of iterations
+	double damping=0.85; 	//!< Damping coefficient
+	double tolerance=0.0; 	//!< The iterations stop as soon as the residual is lower or equal to this value. With 0, all the iterations are run
+	Norm norm=Norm::L1; 	//!< Norm of the residual
+	Thread_pool *pool=nullptr; 	//!< Pool of threads sharing the iterations, or nullptr to run them in the calling thread. The scores do not depend on the number of threads
+	Precision precision=Precision::DOUBLE; 	//!< Floating-point type of the scores during the iterations
+	Kernel kernel=Kernel::AUTO; 	//!< Instruction set used to accumulate the contributions of the neighbours
+	bool warm_start=false; 	//!< Start the iterations from the scores of the previous call instead of 1, scaled so that their mean over the linked nodes is 1. A graph which changed a little since then converges in fewer iterations
+	Solver solver=Solver::JACOBI; 	//!< Method solving the equations of the scores. Only the Jacobi solver uses the pool of threads, the precision and the kernel, the other ones run in the calling thread with 64-bit scores
+};
+
+/**
+ * \brief Result of the TextRank algorithm
+ *
+ * The result is the sorted list of keywords, together with their score, and information about the convergence of the algorithm.
+ */
+class Ranking:public std::vector<std::pair<std::string,double>> {
+	public:
+		int iterations=0; 	//!< Number of iterations actually run. With the push solver, the number of nodes processed divided by the number of nodes, rounded up
+		double residual=0.0; 	//!< Change of the scores during the last iteration, measured with the requested norm. With the push solver, norm of the residuals left on the nodes, which is the change the next Jacobi iteration would make
+		uint64_t traversals=0; 	//!< Number of edges read by the iterations, each non-directional edge counting once for each of its nodes
+};
+
+/**
+ * \brief Word of the sentence being added to the graph
+ *
+ * The word does not hold any string: its surface form is a view on the text, its lemma is located in the dictionary, and the node by its identifier.
+ */
+struct Word {
+	std::string_view text; 	//!< Surface form of the word, pointing into the text
+	Pos pos; 	//!< POS tag of the word
+	int32_t lemma; 	//!< Dictionary entry of the lemma of the word, or -1 if the word was not found or not looked up in the dictionary
+	int32_t node; 	//!< Identifier of the node of the word in the graph, or -1 if the word has no node
 };
 
 /**
  * \brief Graph representation of the text
  *
- * The graph is a list of Node.
+ * Each node of the graph holds a lemma, and is identified by a dense integer. Nodes are linked by weighted non-directional edges. While the text is read, the weights of the edges are accumulated in a single flat hash table, keyed by the pair of nodes of each edge, which only calls the allocator when it grows. Before the TextRank algorithm runs, the edges are frozen in a compressed sparse row (CSR) structure, so that the iterations only sweep over contiguous arrays.
+ *
+ * The text may be given at once, or appended chunk by chunk. Each complete sentence updates the edges and is then forgotten: the graph only keeps the runs of consecutive significant words, which are the candidates of the multi-word keywords, and stores each distinct run once. The memory used by the graph thus depends on its vocabulary rather than on the length of the text, and keywords may be extracted at any time while the text is appended. The runs and the lemmas of the words which are not in the dictionary are kept in an arena, and all of them are freed at once with the graph.
+ *
+ * The graph may also be restricted to the last sentences of the text. The edges of a sentence are then subtracted when it falls out of the window, and the keywords only reflect the sentences of the window. Nodes are kept when their words leave the window, but only the nodes with words in the window may become keywords.
  */
-class Graph:public std::unordered_map<std::wstring,Node> {
+class Graph {
 	public:
 
+		/**
+		 * \brief Create an empty graph, to which the text is appended chunk by chunk
+		 *
+		 * \param dic Dictionary used to POS tag and lemmify words, which must outlive the graph
+		 * \param window_size Size of the window for linked edges
+		 * \param max_sentences Number of sentences kept in the graph: older sentences are removed as new ones are appended. If it is 0, all the sentences are kept
+		 * \param arena Arena holding the unknown lemmas. It must outlive the graph and must not be reset before the graph is destroyed. If it is nullptr, the graph uses its own arena
+		 * \param profile Profile to which the time and counters of the stages are added, or nullptr to measure nothing. It must outlive the graph
+		 * \param cache Cache of the lookups in the dictionary, which must outlive the graph. If it is nullptr, the graph uses its own cache
+		 */
+		Graph(const Dictionary &dic,int window_size,std::size_t max_sentences=0,Arena *arena=nullptr,Profile *profile=nullptr,Word_cache *cache=nullptr);
+
 		/**
 		 * \brief Build the graph from a text
 		 *
-		 * This constructor reads a text from the given input stream and builds the graph from it.
-		 * \param ifs Input stream
-		 * \param dic Dictionary used to POS tag and lemmify words
+		 * This constructor reads a UTF-8 text from the given input stream by chunks and builds the graph from it.
+		 * \param in Input stream
+		 * \param dic Dictionary used to POS tag and lemmify words, which must outlive the graph
 		 * \param window_size Size of the window for linked edges
+		 * \param arena Arena holding the unknown lemmas. It must outlive the graph and must not be reset before the graph is destroyed. If it is nullptr, the graph uses its own arena
+		 * \param profile Profile to which the time and counters of the stages are added, or nullptr to measure nothing. It must outlive the graph
+		 * \param cache Cache of the lookups in the dictionary, which must outlive the graph. If it is nullptr, the graph uses its own cache
 		 */
-		Graph(std::wistream &ifs,const Dictionary &dic,int window_size);
+		Graph(std::istream &in,const Dictionary &dic,int window_size,Arena *arena=nullptr,Profile *profile=nullptr,Word_cache *cache=nullptr);
+
+		/**
+		 * \brief Build the graph from a text in memory
+		 *
+		 * \param text UTF-8 encoded text
+		 * \param dic Dictionary used to POS tag and lemmify words, which must outlive the graph
+		 * \param window_size Size of the window for linked edges
+		 * \param arena Arena holding the unknown lemmas. It must outlive the graph and must not be reset before the graph is destroyed. If it is nullptr, the graph uses its own arena
+		 * \param profile Profile to which the time and counters of the stages are added, or nullptr to measure nothing. It must outlive the graph
+		 * \param cache Cache of the lookups in the dictionary, which must outlive the graph. If it is nullptr, the graph uses its own cache
+		 */
+		Graph(std::string_view text,const Dictionary &dic,int window_size,Arena *arena=nullptr,Profile *profile=nullptr,Word_cache *cache=nullptr);
+
+		Graph(const Graph&)=delete; 	//!< A graph can not be copied
+		Graph& operator=(const Graph&)=delete; 	//!< A graph can not be copied
+
+		/**
+		 * \brief Append a chunk of text to the graph
+		 *
+		 * The chunk may end anywhere, even inside a word or a UTF-8 sequence: the incomplete sentence at its end is kept until the next chunks complete it.
+		 * \param chunk UTF-8 encoded chunk of text
+		 * \param on_sentence Function called after each complete sentence has been added to the graph, or nullptr. It may call text_rank
+		 */
+		void append(std::string_view chunk,const std::function<void()> &on_sentence=nullptr);
+
+		/**
+		 * \brief Add the incomplete sentence at the end of the text
+		 *
+		 * The function is called once the whole text has been appended. The maps of edges are then released, and no more text may be appended.
+		 * \param on_sentence Function called if the last sentence is added to the graph, or nullptr
+		 */
+		void finish(const std::function<void()> &on_sentence=nullptr);
+
+		/**
+		 * \brief Number of sentences with at least one word added to the graph, including the ones which left the window
+		 */
+		std::size_t sentences() const noexcept {return _sentences;}
 
 		/**
 		 * \brief TextRank algorithm
 		 *
-		 * The method updates the score of each node based on the number of inbound edges.
+		 * The method updates the score of each node based on the number of inbound edges. The iterations stop when the maximal number of iterations is reached, or as soon as the residual is lower than the tolerance. While the text is appended, the keywords reflect the sentences added so far.
+		 * \param parameters Parameters of the algorithm
+		 * \return Sorted list of keywords, together with their score
+		 * \throw std::bad_alloc if the scores or the keywords can not be allocated
+		 */
+		Ranking text_rank(const Rank_parameters &parameters);
+
+		/**
+		 * \brief TextRank algorithm with a fixed number of iterations
+		 *
 		 * \param num_keywords Number of keywords expected
 		 * \param num_iterations Number of iterations
 		 * \param d Damping coefficient
 		 * \return Sorted list of keywords, together with their score
+		 * \throw std::bad_alloc if the scores or the keywords can not be allocated
 		 */
-		std::vector<std::pair<std::wstring,double>> text_rank(int num_keywords,int num_iterations,double d) noexcept;
+		Ranking text_rank(int num_keywords,int num_iterations,double d) {return text_rank(Rank_parameters{num_keywords,num_iterations,d});}
+
+		/**
+		 * \brief TextRank algorithm on many graphs at once
+		 *
+		 * The graphs ranked by the Jacobi solver with the same precision and kernel are packed in block-diagonal matrices of at most BATCH_EDGES edges. The iterations of each matrix run in a single loop over the blocks of the graphs which did not converge yet, each block stopping with its own parameters. This avoids the cost of a call for each graph, but the matrix is read again at each iteration, while a small graph ranked alone stays in the first-level cache: on documents of a few dozen words, the batch is about 10 % slower than text_rank on each graph, so that the batch mode does not use it. The keywords, iterations and residuals are identical to those of text_rank on each graph. The graphs ranked by the other solvers, the graphs of more than BATCH_EDGES edges, the graphs whose parameters have a pool of threads and a single graph are ranked one by one, as by text_rank.
+		 * \param graphs Graphs to rank
+		 * \param parameters Parameters of the algorithm for each graph
+		 * \return Sorted list of keywords of each graph, together with their score, in the order of the graphs
+		 * \throw std::invalid_argument if there is not one set of parameters for each graph
+		 */
+		static std::vector<Ranking> text_rank_batch(const std::vector<Graph*> &graphs,const std::vector<Rank_parameters> &parameters);
+
+		/**
+		 * \brief Number of nodes in the graph
+		 */
+		int32_t size() const noexcept {return int32_t(_lemmas.size());}
+
+		/**
+		 * \brief Lemma held by a node
+		 *
+		 * \param node Identifier of the node
+		 * \return Lemma of the node, in UTF-8 encoding
+		 */
+		std::string_view lemma(int32_t node) const noexcept {return _lemmas[node];}
+
+		/**
+		 * \brief Score of a node, as computed by the last call to text_rank
+		 *
+		 * \param node Identifier of the node
+		 * \return Score of the node
+		 */
+		double score(int32_t node) const noexcept {return _scores[node];}
 
 		/**
 		 * \brief Print the whole graph on an output stream
@@ -89,30 +285,256 @@ class Graph:public std::unordered_map<std::wstring,Node> {
 		 * This method is mainly for debug purposes. It prints the full graph in a readable way on an output stream.
 		 * \param out Output stream
 		 */
-		void print(std::wostream &out) const;
+		void print(std::ostream &out) const;
 
 	private:
-		std::vector<std::vector<std::tuple<std::wstring,Pos,std::wstring,Node*>>> _tokens; 	//!< Array of tokens. Each internal array represents a sentence. Each element of the array is made of the orginal word, its POS tag, its associated lemma and a pointer to the node in the graph
+		/**
+		 * \brief Run of consecutive significant words of a sentence, candidate for a multi-word keyword
+		 */
+		struct Run {
+			const int32_t *nodes; 	//!< Nodes of the words
+			uint32_t size; 	//!< Number of words
+			bool operator==(const Run &other) const noexcept {return size==other.size && std::equal(nodes,nodes+size,other.nodes);} 	//!< Compare the nodes of two runs
+		};
 
 		/**
-		 * \brief Add a non-directional edge between two nodes of the graph
+		 * \brief Hash function of the runs
+		 */
+		struct Run_hash {
+			std::size_t operator()(const Run &run) const noexcept;
+		};
+
+		const Dictionary &_dic; 	//!< Dictionary used to POS tag and lemmify words
+		int _window_size; 	//!< Size of the window for linked edges
+		std::unique_ptr<Arena> _own_arena; 	//!< Arena created by the graph, if none was given
+		Arena *_arena; 	//!< Arena holding the unknown lemmas
+		Profile *_profile; 	//!< Profile of the stages, or nullptr
+		std::unique_ptr<Word_cache> _own_cache; 	//!< Cache created by the graph, if none was given
+		Word_cache *_cache; 	//!< Cache of the lookups in the dictionary
+		std::string _pending; 	//!< Incomplete sentence at the end of the text appended so far
+		std::vector<Word> _sentence; 	//!< Words of the sentence being added
+		std::size_t _sentences; 	//!< Number of sentences added to the graph
+		bool _finished; 	//!< Tell if the whole text has been appended
+		bool _frozen; 	//!< Tell if the CSR structure is up to date with the maps of edges
+		bool _rebuild; 	//!< Tell if the CSR structure has to be built again from the table of edges, rather than patched with the changed edges
+		std::size_t _max_sentences; 	//!< Number of sentences kept in the graph, or 0 to keep all of them
+		std::deque<std::vector<int32_t>> _history; 	//!< Nodes of the words of the sentences in the window, -1 for the stop words. Only used if the number of sentences is limited, in which case the runs are not recorded
+		std::vector<int32_t> _occurrences; 	//!< Number of words of each node in the graph, or in the window if the number of sentences is limited
+		std::vector<int32_t> _free_nodes; 	//!< Nodes which have no word left in the window, whose identifiers are given to the next new lemmas
+		std::vector<int32_t> _node_entries; 	//!< Dictionary entry of the lemma of each node, or -1 for the words which are not in the dictionary. Only used if the number of sentences is limited, to forget the lemma of a node which leaves the window
+		std::vector<uint64_t> _changed; 	//!< Keys of the edges whose weight changed since the CSR structure was last updated, possibly repeated. Only used if the number of sentences is limited
+		std::vector<int32_t> _runs; 	//!< Nodes of the distinct runs of at least two words, in the order of their first occurrence, each run being followed by -1
+		Flat_map _run_index; 	//!< Offset of each distinct run in _runs plus 1, by hash of its nodes, released once the whole text has been appended
+		int32_t _run_threshold; 	//!< Number of occurrences under which a node was cut from the runs by their last compaction
+		Flat_map _entry_ids; 	//!< Identifier of the node of each lemma of the dictionary plus 1, by dictionary entry
+		std::unordered_map<std::string_view,int32_t> _word_ids; 	//!< Identifier of the node of each word which is not in the dictionary
+		std::vector<std::string_view> _lemmas; 	//!< Lemma of each node, in UTF-8 encoding. It points into the dictionary, or into the arena for the words which are not in the dictionary
+		Flat_map _edges; 	//!< Weight of each edge, by key of the edge, released once the whole text has been appended
+		std::vector<int32_t> _offsets; 	//!< Edges of node i are stored in the elements [_offsets[i],_offsets[i+1]) of the _neighbors and _weights arrays. If the number of sentences is limited, the last elements of each row are free edges from the node to itself with a weight of 0
+		std::vector<int32_t> _degrees; 	//!< Number of edges of each node, at the start of its row. Only used if the number of sentences is limited
+		std::vector<int32_t> _neighbors; 	//!< Target node of each edge
+		std::vector<int32_t> _weights; 	//!< Weight of each edge
+		std::vector<double> _inv_total; 	//!< Inverse of the sum of the weights of edges from each node, or 0 if the node has no edge
+		std::vector<double> _scores; 	//!< Score of each node
+
+		/**
+		 * \brief Add the complete sentences of a text to the graph
+		 *
+		 * The text is split in sentences and words by the tokenizer, and each sentence is added to the graph.
+		 * \param text UTF-8 encoded text, made of complete sentences unless it is the end of the whole text
+		 * \param on_sentence Function called after each sentence, or nullptr
+		 */
+		void add_text(std::string_view text,const std::function<void()> &on_sentence);
+
+		/**
+		 * \brief Add the complete sentences of a text to the graph, and measure each stage
+		 *
+		 * The text is cut in slices of complete sentences, and each slice is tokenized, looked up and added to the graph in three passes, so that each stage is timed with a few clock reads per slice rather than per word. The time of the function called after each sentence is counted in the construction of the graph.
+		 * \param text UTF-8 encoded text, made of complete sentences unless it is the end of the whole text
+		 * \param on_sentence Function called after each sentence, or nullptr
+		 */
+		void add_text_profiled(std::string_view text,const std::function<void()> &on_sentence);
+
+		/**
+		 * \brief Add the current sentence to the graph
+		 *
+		 * The words of the sentence are linked to the next window_size significant words, and its runs of significant words are recorded.
+		 * \param on_sentence Function called after the sentence, or nullptr
+		 */
+		void add_sentence(const std::function<void()> &on_sentence);
+
+		/**
+		 * \brief Record a run of significant words, if it was not recorded yet
 		 *
-		 * This function adds an edge between two nodes of the graph. If the nodes do not exist, they are created. If the edge already exist, its weight is increased by 1.
-		 * \param a Key of the first node, starting point of the edge
-		 * \param b Key of the second node, to which the new edge is pointed
+		 * The runs are compacted once their nodes exceed the budget given by RUN_NODES_PER_NODE.
+		 * \param first Node of the first word of the run
+		 * \param last End of the nodes of the run
 		 */
-		void add_edge(const std::wstring &a,const std::wstring &b) noexcept;
+		void add_run(const int32_t *first,const int32_t *last);
+
+		/**
+		 * \brief Cut the runs at their rarest nodes so that they fill at most half of their budget
+		 *
+		 * The number of occurrences under which a node is cut from the runs is raised until few enough nodes are kept, and the runs are split at the nodes which are cut. The parts of less than two nodes are dropped, and the repeated parts are only kept once. A multi-word keyword made of a node which was cut is then missed, but such a node is among the least likely to become a keyword.
+		 */
+		void compact_runs();
+
+		/**
+		 * \brief Identifier of the node holding the lemma of a word
+		 *
+		 * The node is created if it does not exist, with the identifier of a node which left the window of sentences if there is one. Lemmas of the dictionary are identified by their entry. Words which are not in the dictionary are their own lemma, and are copied in the arena.
+		 * \param word Word, which must not be a stop word
+		 * \return Identifier of the node
+		 */
+		int32_t node(const Word &word);
 
 		/**
 		 * \brief Add a non-directional edge between two nodes of the graph
 		 *
 		 * This function adds an edge between two nodes of the graph. If the edge already exist, its weight is increased by 1.
-		 * \param a Key of the first node, starting point of the edge
-		 * \param na First node, starting point of the edge
-		 * \param b Key of the second node, to which the new edge is pointed
-		 * \param nb Second node, to which the new edge is pointed
+		 * \param a Identifier of the first node, starting point of the edge
+		 * \param b Identifier of the second node, to which the new edge is pointed
+		 */
+		void add_edge(int32_t a,int32_t b);
+
+		/**
+		 * \brief Remove one unit of weight from a non-directional edge
+		 *
+		 * The edge is removed when its weight drops to 0.
+		 * \param a Identifier of the first node
+		 * \param b Identifier of the second node
+		 */
+		void remove_edge(int32_t a,int32_t b) noexcept;
+
+		/**
+		 * \brief Record that the weight of an edge changed, so that its rows of the CSR structure are patched
+		 *
+		 * The CSR structure is built again instead once more edges changed than the graph has.
+		 * \param key Key of the edge
+		 */
+		void change_edge(uint64_t key);
+
+		/**
+		 * \brief Forget a node which has no word left in the window of sentences
+		 *
+		 * Its lemma is removed from the tables of the nodes, and its identifier is given to the next new lemma. The node has no edge left.
+		 * \param a Identifier of the node
+		 */
+		void release(int32_t a);
+
+		/**
+		 * \brief Key of a non-directional edge in the table of edges
+		 *
+		 * \param a Identifier of the first node
+		 * \param b Identifier of the second node
+		 * \return Identifiers of both nodes packed in 64 bits, the lower one in the upper bits, so that both directions give the same key
+		 */
+		static uint64_t edge_key(int32_t a,int32_t b) noexcept {return (a<b)?(uint64_t(uint32_t(a))<<32)|uint32_t(b):(uint64_t(uint32_t(b))<<32)|uint32_t(a);}
+
+		/**
+		 * \brief Link the significant words of a sentence, or unlink them
+		 *
+		 * Each word is linked to the next window_size significant words.
+		 * \param nodes Nodes of the words of the sentence, -1 for the stop words
+		 * \param add True to add the edges, false to subtract them
+		 */
+		void link(const std::vector<int32_t> &nodes,bool add);
+
+		/**
+		 * \brief Iterations of the TextRank algorithm
+		 *
+		 * The method runs the iterations with scores of type T, and stores the resulting scores.
+		 * \param parameters Parameters of the algorithm
+		 * \param kernel Kernel accumulating the contributions of the neighbours
+		 * \param res Result, whose number of iterations and residual are updated
+		 */
+		template<class T> void iterate(const Rank_parameters &parameters,Gather_kernel<T> kernel,Ranking &res) noexcept;
+
+		/**
+		 * \brief Iterations of the TextRank algorithm on a block-diagonal matrix of frozen graphs
+		 *
+		 * \param graphs Graphs of the batch
+		 * \param parameters Parameters of the algorithm for each graph of the batch
+		 * \param members Indices of the graphs packed in the matrix, whose parameters share the same precision and kernel
+		 * \param kernel Kernel accumulating the contributions of the neighbours
+		 * \param res Result of each graph of the batch. The number of iterations, residual and traversals of the members are updated
+		 */
+		template<class T> static void iterate_batch(const std::vector<Graph*> &graphs,const std::vector<Rank_parameters> &parameters,const std::vector<std::size_t> &members,Gather_kernel<T> kernel,std::vector<Ranking> &res);
+
+		/**
+		 * \brief Run the iterations of the selected solver
+		 *
+		 * \param parameters Parameters of the algorithm
+		 * \param res Result, whose number of iterations, residual and traversals are updated
+		 */
+		void iterate_solver(const Rank_parameters &parameters,Ranking &res);
+
+		/**
+		 * \brief Assemble the keywords from the scores of the nodes
+		 *
+		 * The counters of the ranking are added to the profile. The single-word keywords are the nodes with the best scores, and consecutive keywords of the runs make multi-word keywords, whose score is the sum of the scores of their words.
+		 * \param num_keywords Number of keywords expected
+		 * \param res Result of the iterations, to which the sorted keywords are added
+		 */
+		void assemble(int num_keywords,Ranking &res) const;
+
+		/**
+		 * \brief Initial scores of the iterations
+		 *
+		 * \param parameters Parameters of the algorithm
+		 * \return 1 for each node, or the scores of the previous call scaled to a mean of 1 over the linked nodes if the iterations start warm
+		 */
+		template<class T> std::vector<T> initial_scores(const Rank_parameters &parameters) const;
+
+		/**
+		 * \brief Iterations of the Gauss-Seidel solver
+		 *
+		 * Each sweep updates the scores in place, in the order of the identifiers of the nodes.
+		 * \param parameters Parameters of the algorithm
+		 * \param res Result, whose number of iterations, residual and traversals are updated
+		 */
+		void iterate_gauss_seidel(const Rank_parameters &parameters,Ranking &res);
+
+		/**
+		 * \brief Iterations of the power method with Aitken extrapolation
+		 *
+		 * \param parameters Parameters of the algorithm
+		 * \param res Result, whose number of iterations, residual and traversals are updated
+		 */
+		void iterate_aitken(const Rank_parameters &parameters,Ranking &res);
+
+		/**
+		 * \brief Pushes of the residuals of the Gauss-Southwell solver
+		 *
+		 * \param parameters Parameters of the algorithm
+		 * \param res Result, whose number of iterations, residual and traversals are updated
+		 */
+		void iterate_push(const Rank_parameters &parameters,Ranking &res);
+
+		/**
+		 * \brief Freeze the edges of the graph in the CSR structure
+		 *
+		 * The CSR structure is rebuilt from the table of edges if it changed since the last call, and the inverse of the total weight of each node is precomputed. If the number of sentences is limited, only the rows of the changed edges are patched whenever possible.
+		 */
+		void freeze();
+
+		/**
+		 * \brief Set the weight of an edge in the row of a node of the CSR structure
+		 *
+		 * The edges of the row stay sorted by neighbour. An edge whose weight is 0 is removed.
+		 * \param a Identifier of the node of the row
+		 * \param b Identifier of the neighbour
+		 * \param w Weight of the edge in the row
+		 * \return False if the edge had to be inserted in a row which has no free edge left
+		 */
+		bool set_edge(int32_t a,int32_t b,int32_t w) noexcept;
+
+		/**
+		 * \brief Patch the rows of the CSR structure with the edges which changed since the last update
+		 *
+		 * \return False if a row is full, in which case the CSR structure must be built again
 		 */
-		void add_edge(const std::wstring &a,Node &na,const std::wstring &b,Node &nb) noexcept;
+		bool patch_rows();
 };
 
 #endif   /* ----- #ifndef GRAPH_INC  ----- */
@@ -0,0 +1,274 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  json.cpp
+ *
+ *    Description:  Implementation of the minimal JSON parser and writer
+ *
+ *        Version:  1.0
+ *        Created:  18/10/2026 09:31:50
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  François Hissel
+ *   Organization:
+ *
+ * =====================================================================================
+ */
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <stdexcept>
+#include <cstdlib>
+#include <cmath>
+#include <limits>
+#include "json.h"
+
+using namespace std;
+
+/*********************************************
+ *                 Parser                    *
+ *********************************************/
+/**
+ * \brief Recursive descent parser of a JSON text
+ */
+class Json_parser {
+	public:
+		/**
+		 * \brief Create a parser on a text
+		 *
+		 * \param text JSON text
+		 */
+		explicit Json_parser(string_view text):_text(text),_pos(0) {}
+
+		/**
+		 * \brief Parse a value and check that nothing but spaces follows it
+		 *
+		 * \return Parsed value
+		 */
+		Json parse_document() {
+			auto res=parse_value(0);
+			skip_spaces();
+			if (_pos!=_text.size()) fail("unexpected character after the value");
+			return res;
+		}
+
+	private:
+		string_view _text; 	//!< Text
+		size_t _pos; 	//!< Position of the next character
+
+		/**
+		 * \brief Maximal depth of nested arrays and objects
+		 */
+		static constexpr int MAX_DEPTH=64;
+
+		[[noreturn]] void fail(const char *message) const {
+			throw runtime_error(string("Invalid JSON at position ")+to_string(_pos)+": "+message);
+		}
+
+		void skip_spaces() noexcept {
+			while (_pos<_text.size() && (_text[_pos]==' ' || _text[_pos]=='\t' || _text[_pos]=='\n' || _text[_pos]=='\r')) ++_pos;
+		}
+
+		void expect(string_view word) {
+			if (_text.substr(_pos,word.size())!=word) fail("unknown literal");
+			_pos+=word.size();
+		}
+
+		/**
+		 * \brief Append a code point to a UTF-8 string
+		 */
+		static void append_utf8(string &s,unsigned long c) {
+			if (c<0x80) s.push_back(char(c));
+			else if (c<0x800) {
+				s.push_back(char(0xC0|(c>>6)));
+				s.push_back(char(0x80|(c&0x3F)));
+			} else if (c<0x10000) {
+				s.push_back(char(0xE0|(c>>12)));
+				s.push_back(char(0x80|((c>>6)&0x3F)));
+				s.push_back(char(0x80|(c&0x3F)));
+			} else {
+				s.push_back(char(0xF0|(c>>18)));
+				s.push_back(char(0x80|((c>>12)&0x3F)));
+				s.push_back(char(0x80|((c>>6)&0x3F)));
+				s.push_back(char(0x80|(c&0x3F)));
+			}
+		}
+
+		unsigned long parse_hex4() {
+			if (_pos+4>_text.size()) fail("truncated escape sequence");
+			unsigned long res=0;
+			for (int i=0;i<4;++i) {
+				char c=_text[_pos++];
+				res<<=4;
+				if (c>='0' && c<='9') res|=c-'0';
+				else if (c>='a' && c<='f') res|=c-'a'+10;
+				else if (c>='A' && c<='F') res|=c-'A'+10;
+				else fail("invalid escape sequence");
+			}
+			return res;
+		}
+
+		string parse_string() {
+			++_pos;
+			string res;
+			for (;;) {
+				if (_pos>=_text.size()) fail("unterminated string");
+				char c=_text[_pos++];
+				if (c=='"') return res;
+				if (c!='\\') {
+					res.push_back(c);
+					continue;
+				}
+				if (_pos>=_text.size()) fail("unterminated string");
+				c=_text[_pos++];
+				switch (c) {
+					case '"':res.push_back('"');break;
+					case '\\':res.push_back('\\');break;
+					case '/':res.push_back('/');break;
+					case 'b':res.push_back('\b');break;
+					case 'f':res.push_back('\f');break;
+					case 'n':res.push_back('\n');break;
+					case 'r':res.push_back('\r');break;
+					case 't':res.push_back('\t');break;
+					case 'u': {
+						auto cp=parse_hex4();
+						if (cp>=0xD800 && cp<0xDC00 && _text.substr(_pos,2)=="\\u") {
+							_pos+=2;
+							auto low=parse_hex4();
+							if (low>=0xDC00 && low<0xE000) cp=0x10000+((cp-0xD800)<<10)+(low-0xDC00);
+							else fail("invalid surrogate pair");
+						}
+						append_utf8(res,cp);
+						break;
+					}
+					default:fail("invalid escape sequence");
+				}
+			}
+		}
+
+		Json parse_value(int depth) {
+			if (depth>MAX_DEPTH) fail("too many nested values");
+			skip_spaces();
+			if (_pos>=_text.size()) fail("unexpected end of text");
+			Json res;
+			char c=_text[_pos];
+			if (c=='"') {
+				res.type=Json_type::STRING;
+				res.string=parse_string();
+			} else if (c=='{') {
+				res.type=Json_type::OBJECT;
+				++_pos;
+				skip_spaces();
+				if (_pos<_text.size() && _text[_pos]=='}') {++_pos;return res;}
+				for (;;) {
+					skip_spaces();
+					if (_pos>=_text.size() || _text[_pos]!='"') fail("expected a member name");
+					auto name=parse_string();
+					skip_spaces();
+					if (_pos>=_text.size() || _text[_pos]!=':') fail("expected ':'");
+					++_pos;
+					res.object.emplace_back(move(name),parse_value(depth+1));
+					skip_spaces();
+					if (_pos<_text.size() && _text[_pos]==',') {++_pos;continue;}
+					if (_pos<_text.size() && _text[_pos]=='}') {++_pos;break;}
+					fail("expected ',' or '}'");
+				}
+			} else if (c=='[') {
+				res.type=Json_type::ARRAY;
+				++_pos;
+				skip_spaces();
+				if (_pos<_text.size() && _text[_pos]==']') {++_pos;return res;}
+				for (;;) {
+					res.array.push_back(parse_value(depth+1));
+					skip_spaces();
+					if (_pos<_text.size() && _text[_pos]==',') {++_pos;continue;}
+					if (_pos<_text.size() && _text[_pos]==']') {++_pos;break;}
+					fail("expected ',' or ']'");
+				}
+			} else if (c=='t') {
+				expect("true");
+				res.type=Json_type::BOOLEAN;
+				res.boolean=true;
+			} else if (c=='f') {
+				expect("false");
+				res.type=Json_type::BOOLEAN;
+			} else if (c=='n') {
+				expect("null");
+			} else if (c=='-' || (c>='0' && c<='9')) {
+				auto start=_pos;
+				while (_pos<_text.size() && (string_view("+-.eE").find(_text[_pos])!=string_view::npos || (_text[_pos]>='0' && _text[_pos]<='9'))) ++_pos;
+				string number(_text.substr(start,_pos-start));
+				char *end;
+				res.type=Json_type::NUMBER;
+				res.number=strtod(number.c_str(),&end);
+				if (*end!='\0') fail("invalid number");
+			} else fail("unexpected character");
+			return res;
+		}
+};
+
+/*********************************************
+ *                  Json                     *
+ *********************************************/
+Json Json::parse(string_view text) {
+	return Json_parser(text).parse_document();
+}
+
+const Json *Json::find(string_view name) const noexcept {
+	if (type!=Json_type::OBJECT) return nullptr;
+	for (const auto &it:object) if (it.first==name) return &it.second;
+	return nullptr;
+}
+
+void print_json_string(ostream &out,string_view s) {
+	static const char hex[]="0123456789abcdef";
+	out << '"';
+	for (char c:s) {
+		switch (c) {
+			case '"':out << "\\\"";break;
+			case '\\':out << "\\\\";break;
+			case '\n':out << "\\n";break;
+			case '\r':out << "\\r";break;
+			case '\t':out << "\\t";break;
+			default:
+				if ((unsigned char)(c)<0x20) out << "\\u00" << hex[(c>>4)&0xF] << hex[c&0xF];
+				else out << c;
+		}
+	}
+	out << '"';
+}
+
+void Json::print(ostream &out) const {
+	switch (type) {
+		case Json_type::NUL:out << "null";break;
+		case Json_type::BOOLEAN:out << (boolean?"true":"false");break;
+		case Json_type::NUMBER:
+			if (isfinite(number)) {
+				auto precision=out.precision(numeric_limits<double>::max_digits10);
+				out << number;
+				out.precision(precision);
+			} else out << "null";
+			break;
+		case Json_type::STRING:print_json_string(out,string);break;
+		case Json_type::ARRAY:
+			out << '[';
+			for (size_t i=0;i<array.size();++i) {
+				if (i>0) out << ',';
+				array[i].print(out);
+			}
+			out << ']';
+			break;
+		case Json_type::OBJECT:
+			out << '{';
+			for (size_t i=0;i<object.size();++i) {
+				if (i>0) out << ',';
+				print_json_string(out,object[i].first);
+				out << ':';
+				object[i].second.print(out);
+			}
+			out << '}';
+			break;
+	}
+}
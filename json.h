@@ -0,0 +1,88 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  json.h
+ *
+ *    Description:  Minimal JSON values, parser and writer used for the batch input
+ *    				and output records
+ *
+ *        Version:  1.0
+ *        Created:  18/10/2026 09:14:27
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  François Hissel
+ *   Organization:
+ *
+ * =====================================================================================
+ */
+
+#ifndef  JSON_INC
+#define  JSON_INC
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+
+/**
+ * \brief Type of a JSON value
+ */
+enum class Json_type {
+	NUL, 	//!< null
+	BOOLEAN, 	//!< true or false
+	NUMBER, 	//!< Number
+	STRING, 	//!< String
+	ARRAY, 	//!< Array of values
+	OBJECT 	//!< Object, list of named values
+};
+
+/**
+ * \brief JSON value
+ */
+class Json {
+	public:
+		Json_type type=Json_type::NUL; 	//!< Type of the value
+		bool boolean=false; 	//!< Value of a boolean
+		double number=0.0; 	//!< Value of a number
+		std::string string; 	//!< Value of a string, in UTF-8 encoding
+		std::vector<Json> array; 	//!< Elements of an array
+		std::vector<std::pair<std::string,Json>> object; 	//!< Members of an object, in the order of the text
+
+		/**
+		 * \brief Parse a JSON text
+		 *
+		 * \param text JSON text, which must hold exactly one value
+		 * \return Parsed value
+		 * \throw std::runtime_error if the text is not valid JSON
+		 */
+		static Json parse(std::string_view text);
+
+		/**
+		 * \brief Member of an object
+		 *
+		 * \param name Name of the member
+		 * \return Pointer to the value of the member, or nullptr if the value is not an object or has no such member
+		 */
+		const Json *find(std::string_view name) const noexcept;
+
+		/**
+		 * \brief Write the value as JSON text
+		 *
+		 * \param out Output stream
+		 */
+		void print(std::ostream &out) const;
+};
+
+inline std::ostream& operator<<(std::ostream &out,const Json &a) {a.print(out);return out;}
+
+/**
+ * \brief Write a string as a JSON string literal
+ *
+ * \param out Output stream
+ * \param s UTF-8 encoded string
+ */
+void print_json_string(std::ostream &out,std::string_view s);
+
+#endif   /* ----- #ifndef JSON_INC  ----- */
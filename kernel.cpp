@@ -0,0 +1,187 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  kernel.cpp
+ *
+ *    Description:  Implementation of the vectorized kernels of the TextRank iterations
+ *
+ *        Version:  1.0
+ *        Created:  17/10/2026 16:22:03
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  François Hissel
+ *   Organization:
+ *
+ * =====================================================================================
+ */
+
+#include <cstdint>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define KERNEL_X86
+#endif
+#include "kernel.h"
+
+/*********************************************
+ *             Scalar kernel                 *
+ *********************************************/
+/**
+ * \brief Portable accumulation kernel
+ */
+template<class T> void gather_scalar(const int32_t *offsets,const int32_t *neighbors,const int32_t *weights,const T *contrib,T *sums,int32_t begin,int32_t end) {
+	for (int32_t v=begin;v<end;++v) {
+		T sum=0;
+		for (auto j=offsets[v];j<offsets[v+1];++j) sum+=T(weights[j])*contrib[neighbors[j]];
+		sums[v-begin]=sum;
+	}
+}
+
+#ifdef KERNEL_X86
+/*********************************************
+ *              AVX2 kernels                 *
+ *********************************************/
+/**
+ * \brief AVX2 accumulation kernel for 64-bit scores, 4 edges at a time
+ */
+__attribute__((target("avx2,fma"))) void gather_avx2_double(const int32_t *offsets,const int32_t *neighbors,const int32_t *weights,const double *contrib,double *sums,int32_t begin,int32_t end) {
+	for (int32_t v=begin;v<end;++v) {
+		auto j=offsets[v];
+		auto last=offsets[v+1];
+		__m256d acc=_mm256_setzero_pd();
+		for (;j+4<=last;j+=4) {
+			__m128i idx=_mm_loadu_si128(reinterpret_cast<const __m128i*>(neighbors+j));
+			__m256d w=_mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i*>(weights+j)));
+			acc=_mm256_fmadd_pd(w,_mm256_i32gather_pd(contrib,idx,8),acc);
+		}
+		__m128d half=_mm_add_pd(_mm256_castpd256_pd128(acc),_mm256_extractf128_pd(acc,1));
+		double sum=_mm_cvtsd_f64(_mm_add_sd(half,_mm_unpackhi_pd(half,half)));
+		for (;j<last;++j) sum+=double(weights[j])*contrib[neighbors[j]];
+		sums[v-begin]=sum;
+	}
+}
+
+/**
+ * \brief AVX2 accumulation kernel for 32-bit scores, 8 edges at a time
+ */
+__attribute__((target("avx2,fma"))) void gather_avx2_float(const int32_t *offsets,const int32_t *neighbors,const int32_t *weights,const float *contrib,float *sums,int32_t begin,int32_t end) {
+	for (int32_t v=begin;v<end;++v) {
+		auto j=offsets[v];
+		auto last=offsets[v+1];
+		__m256 acc=_mm256_setzero_ps();
+		for (;j+8<=last;j+=8) {
+			__m256i idx=_mm256_loadu_si256(reinterpret_cast<const __m256i*>(neighbors+j));
+			__m256 w=_mm256_cvtepi32_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights+j)));
+			acc=_mm256_fmadd_ps(w,_mm256_i32gather_ps(contrib,idx,4),acc);
+		}
+		__m128 half=_mm_add_ps(_mm256_castps256_ps128(acc),_mm256_extractf128_ps(acc,1));
+		half=_mm_add_ps(half,_mm_movehl_ps(half,half));
+		float sum=_mm_cvtss_f32(_mm_add_ss(half,_mm_movehdup_ps(half)));
+		for (;j<last;++j) sum+=float(weights[j])*contrib[neighbors[j]];
+		sums[v-begin]=sum;
+	}
+}
+
+/*********************************************
+ *             AVX-512 kernels               *
+ *********************************************/
+/**
+ * \brief AVX-512 accumulation kernel for 64-bit scores, 8 edges at a time
+ */
+__attribute__((target("avx512f"))) void gather_avx512_double(const int32_t *offsets,const int32_t *neighbors,const int32_t *weights,const double *contrib,double *sums,int32_t begin,int32_t end) {
+	for (int32_t v=begin;v<end;++v) {
+		auto j=offsets[v];
+		auto last=offsets[v+1];
+		__m512d acc=_mm512_setzero_pd();
+		for (;j+8<=last;j+=8) {
+			__m256i idx=_mm256_loadu_si256(reinterpret_cast<const __m256i*>(neighbors+j));
+			__m512d w=_mm512_cvtepi32_pd(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights+j)));
+			acc=_mm512_fmadd_pd(w,_mm512_i32gather_pd(idx,contrib,8),acc);
+		}
+		// The remaining edges are processed with a masked gather
+		if (j<last) {
+			__mmask8 mask=__mmask8((1u<<(last-j))-1);
+			__m256i idx=_mm512_castsi512_si256(_mm512_maskz_loadu_epi32(mask,neighbors+j));
+			__m512d w=_mm512_cvtepi32_pd(_mm512_castsi512_si256(_mm512_maskz_loadu_epi32(mask,weights+j)));
+			acc=_mm512_fmadd_pd(w,_mm512_mask_i32gather_pd(_mm512_setzero_pd(),mask,idx,contrib,8),acc);
+		}
+		sums[v-begin]=_mm512_reduce_add_pd(acc);
+	}
+}
+
+/**
+ * \brief AVX-512 accumulation kernel for 32-bit scores, 16 edges at a time
+ */
+__attribute__((target("avx512f"))) void gather_avx512_float(const int32_t *offsets,const int32_t *neighbors,const int32_t *weights,const float *contrib,float *sums,int32_t begin,int32_t end) {
+	for (int32_t v=begin;v<end;++v) {
+		auto j=offsets[v];
+		auto last=offsets[v+1];
+		__m512 acc=_mm512_setzero_ps();
+		for (;j+16<=last;j+=16) {
+			__m512i idx=_mm512_loadu_si512(neighbors+j);
+			__m512 w=_mm512_cvtepi32_ps(_mm512_loadu_si512(weights+j));
+			acc=_mm512_fmadd_ps(w,_mm512_i32gather_ps(idx,contrib,4),acc);
+		}
+		if (j<last) {
+			__mmask16 mask=__mmask16((1u<<(last-j))-1);
+			__m512i idx=_mm512_maskz_loadu_epi32(mask,neighbors+j);
+			__m512 w=_mm512_cvtepi32_ps(_mm512_maskz_loadu_epi32(mask,weights+j));
+			acc=_mm512_fmadd_ps(w,_mm512_mask_i32gather_ps(_mm512_setzero_ps(),mask,idx,contrib,4),acc);
+		}
+		sums[v-begin]=_mm512_reduce_add_ps(acc);
+	}
+}
+#endif
+
+/*********************************************
+ *                Dispatch                   *
+ *********************************************/
+Kernel best_kernel() noexcept {
+#ifdef KERNEL_X86
+	if (__builtin_cpu_supports("avx512f")) return Kernel::AVX512;
+	if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return Kernel::AVX2;
+#endif
+	return Kernel::SCALAR;
+}
+
+const char *kernel_name(Kernel kernel) noexcept {
+	switch (kernel) {
+		case Kernel::AUTO:return "auto";
+		case Kernel::SCALAR:return "scalar";
+		case Kernel::AVX2:return "avx2";
+		case Kernel::AVX512:return "avx512";
+	}
+	return "";
+}
+
+/**
+ * \brief Instruction set actually used for a requested one
+ *
+ * \param kernel Requested instruction set
+ * \return Requested instruction set if the processor supports it, the best supported one otherwise
+ */
+Kernel supported_kernel(Kernel kernel) noexcept {
+	auto best=best_kernel();
+	if (kernel==Kernel::AUTO || (kernel==Kernel::AVX512 && best!=Kernel::AVX512) || (kernel==Kernel::AVX2 && best==Kernel::SCALAR)) return best;
+	return kernel;
+}
+
+Gather_kernel<double> gather_kernel_double(Kernel kernel) noexcept {
+	switch (supported_kernel(kernel)) {
+#ifdef KERNEL_X86
+		case Kernel::AVX512:return gather_avx512_double;
+		case Kernel::AVX2:return gather_avx2_double;
+#endif
+		default:return gather_scalar<double>;
+	}
+}
+
+Gather_kernel<float> gather_kernel_float(Kernel kernel) noexcept {
+	switch (supported_kernel(kernel)) {
+#ifdef KERNEL_X86
+		case Kernel::AVX512:return gather_avx512_float;
+		case Kernel::AVX2:return gather_avx2_float;
+#endif
+		default:return gather_scalar<float>;
+	}
+}
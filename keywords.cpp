@@ -18,16 +18,109 @@
  * =====================================================================================
  */
 
-#include <locale>
-#include <codecvt>
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <stdexcept>
+#include <memory>
+#include <vector>
+#include <string_view>
+#include <csignal>
+#include <getopt.h>
+#include "profile.h"
 #include "dictionary.h"
+#include "thread_pool.h"
 #include "graph.h"
+#include "document.h"
+#include "pipeline.h"
+#include "server.h"
+#include "textrank.h"
 
 using namespace std;
 
+/**
+ * \brief Server to stop when an interruption signal is received, if the program runs as a server
+ */
+static Server *running_server=nullptr;
+
+/**
+ * \brief Handler of the interruption signals in server mode
+ *
+ * \param signal Number of the signal
+ */
+extern "C" void stop_server(int signal) {
+	if (running_server!=nullptr) running_server->stop();
+}
+
+/**
+ * \brief Print the syntax of the program on the standard error
+ */
+void usage() {
+	cerr << "Syntax: keywords [options] path_to_dictionary [path_to_file]\n"
+		"       keywords -b files [options] path_to_dictionary path_to_file...\n"
+		"       keywords -b jsonl|nul [options] path_to_dictionary [path_to_stream]\n"
+		"       keywords -S path_to_socket [options] path_to_dictionary\n"
+		"Options:\n"
+		"  -l, --lookup=search|hash   Lookup engine of the dictionary (default: hash if available)\n"
+		"  -k, --keywords=N           Number of keywords (default: 10)\n"
+		"  -w, --window=N             Size of the window for linked words (default: 3)\n"
+		"  -n, --iterations=N         Maximal number of iterations of TextRank (default: 20)\n"
+		"  -d, --damping=X            Damping coefficient (default: 0.85)\n"
+		"  -e, --tolerance=X          Stop as soon as the residual is lower than X, 0 to always run all the iterations (default: 0)\n"
+		"  -r, --norm=l1|linf         Norm of the residual (default: l1)\n"
+		"  -p, --precision=double|float  Floating-point type of the scores during the iterations (default: double)\n"
+		"  -x, --kernel=auto|scalar|avx2|avx512  Instruction set of the iterations (default: auto)\n"
+		"  -m, --solver=jacobi|gauss-seidel|aitken|push  Method solving the TextRank equations, push being only worth it on skewed graphs (default: jacobi)\n"
+		"  -t, --threads=N            Number of threads running the iterations of TextRank (default: 1)\n"
+		"  -s, --stats                Print the number of iterations, the final residual and the number of edges read on standard error\n"
+		"  -b, --batch=files|jsonl|nul  Extract the keywords of many documents and write one JSON record per document\n"
+		"  -B, --batch-size=N         Largest number of short documents handed together to a worker in batch mode (default: 64)\n"
+		"  -j, --jobs=N               Number of documents processed in parallel in batch and server modes, 0 for the number of hardware threads (default: 1)\n"
+		"  -S, --server=PATH          Serve JSONL requests on the Unix domain socket PATH until interrupted\n"
+		"  -I, --max-iterations=N     Largest number of iterations a request to the server may ask for (default: 10000)\n"
+		"  -N, --snapshot=N           Print the keywords of the text read so far every N sentences\n"
+		"  -W, --sentences=N          Only keep the last N sentences in the graph, 0 to keep all of them (default: 0)\n"
+		"  -a, --warm-start           Start the iterations of each snapshot from the scores of the previous one\n"
+		"  -P, --profile=text|json    Measure the time and counters of each stage and print them on standard error\n";
+}
+
+/**
+ * \brief Throw an exception with the message of the last error of the library if a call failed
+ *
+ * \param status Status returned by the call
+ * \throw std::runtime_error if the call failed
+ */
+void check(textrank_status status) {
+	if (status!=TEXTRANK_OK) throw runtime_error(textrank_last_error());
+}
+
+/**
+ * \brief Print keywords on the standard output
+ *
+ * \param res Keywords and their scores
+ */
+void print_keywords(const textrank_result &res) {
+	for (size_t i=0;i<res.count;++i) {
+		cout.write(res.keywords[i].text,res.keywords[i].length) << '\t' << res.keywords[i].score << '\n';
+	}
+}
+
+/**
+ * \brief Print the keywords of the text read so far if the number of sentences is a multiple of the period of the snapshots
+ *
+ * \param extractor Extractor of the text
+ * \param user Period of the snapshots, in sentences
+ */
+extern "C" void print_snapshot(textrank_extractor *extractor,void *user) {
+	auto sentences=textrank_sentences(extractor);
+	if (sentences%*static_cast<size_t*>(user)!=0) return;
+	cout << "# " << sentences << " sentences\n";
+	textrank_result res;
+	check(textrank_rank(extractor,&res));
+	print_keywords(res);
+	cout.flush();
+}
+
 /**
  * \brief Main program
  *
@@ -36,22 +129,190 @@ using namespace std;
  * \return 0 if the execution was successful, an error code otherwise
  */
 int main(int argc,char *argv[]) {
-	if (argc<2) {
-		cerr << "Syntax: keywords [path_do_dictionary] [path_to_file]\n";
+	Lookup method=Lookup::AUTO;
+	Rank_parameters parameters;
+	int window_size=3;
+	bool stats=false;
+	int threads=1;
+	bool batch=false;
+	int jobs=1;
+	size_t batch_size=64;
+	string socket_path;
+	int max_iterations=MAX_REQUEST_ITERATIONS;
+	size_t snapshot=0;
+	size_t max_sentences=0;
+	string profile_format;
+	Input input=Input::FILES;
+	static const option options[]={
+		{"lookup",required_argument,nullptr,'l'},
+		{"keywords",required_argument,nullptr,'k'},
+		{"window",required_argument,nullptr,'w'},
+		{"iterations",required_argument,nullptr,'n'},
+		{"damping",required_argument,nullptr,'d'},
+		{"tolerance",required_argument,nullptr,'e'},
+		{"norm",required_argument,nullptr,'r'},
+		{"precision",required_argument,nullptr,'p'},
+		{"kernel",required_argument,nullptr,'x'},
+		{"solver",required_argument,nullptr,'m'},
+		{"threads",required_argument,nullptr,'t'},
+		{"stats",no_argument,nullptr,'s'},
+		{"batch",required_argument,nullptr,'b'},
+		{"batch-size",required_argument,nullptr,'B'},
+		{"jobs",required_argument,nullptr,'j'},
+		{"server",required_argument,nullptr,'S'},
+		{"max-iterations",required_argument,nullptr,'I'},
+		{"snapshot",required_argument,nullptr,'N'},
+		{"sentences",required_argument,nullptr,'W'},
+		{"warm-start",no_argument,nullptr,'a'},
+		{"profile",required_argument,nullptr,'P'},
+		{nullptr,0,nullptr,0}
+	};
+	try {
+		int opt;
+		while ((opt=getopt_long(argc,argv,"l:k:w:n:d:e:r:p:x:m:t:sb:B:j:S:I:N:W:aP:",options,nullptr))!=-1) {
+			switch (opt) {
+				case 'l':
+					if (string(optarg)=="search") method=Lookup::SEARCH;
+					else if (string(optarg)=="hash") method=Lookup::HASH;
+					else throw invalid_argument(string("Unknown lookup engine ")+optarg);
+					break;
+				case 'k':parameters.num_keywords=stoi(optarg);break;
+				case 'w':window_size=stoi(optarg);break;
+				case 'n':parameters.max_iterations=stoi(optarg);break;
+				case 'd':parameters.damping=stod(optarg);break;
+				case 'e':parameters.tolerance=stod(optarg);break;
+				case 'r':
+					if (string(optarg)=="l1") parameters.norm=Norm::L1;
+					else if (string(optarg)=="linf") parameters.norm=Norm::LINF;
+					else throw invalid_argument(string("Unknown norm ")+optarg);
+					break;
+				case 'p':
+					if (string(optarg)=="double") parameters.precision=Precision::DOUBLE;
+					else if (string(optarg)=="float") parameters.precision=Precision::FLOAT;
+					else throw invalid_argument(string("Unknown precision ")+optarg);
+					break;
+				case 'x':
+					if (string(optarg)=="auto") parameters.kernel=Kernel::AUTO;
+					else if (string(optarg)=="scalar") parameters.kernel=Kernel::SCALAR;
+					else if (string(optarg)=="avx2") parameters.kernel=Kernel::AVX2;
+					else if (string(optarg)=="avx512") parameters.kernel=Kernel::AVX512;
+					else throw invalid_argument(string("Unknown kernel ")+optarg);
+					break;
+				case 'm':parameters.solver=solver_from_name(optarg);break;
+				case 't':threads=stoi(optarg);break;
+				case 's':stats=true;break;
+				case 'b':
+					batch=true;
+					if (string(optarg)=="files") input=Input::FILES;
+					else if (string(optarg)=="jsonl") input=Input::JSONL;
+					else if (string(optarg)=="nul") input=Input::NUL;
+					else throw invalid_argument(string("Unknown batch input ")+optarg);
+					break;
+				case 'B':batch_size=stoul(optarg);break;
+				case 'j':jobs=stoi(optarg);break;
+				case 'S':socket_path=optarg;break;
+				case 'I':max_iterations=stoi(optarg);break;
+				case 'N':snapshot=stoul(optarg);break;
+				case 'W':max_sentences=stoul(optarg);break;
+				case 'a':parameters.warm_start=true;break;
+				case 'P':
+					profile_format=optarg;
+					if (profile_format!="text" && profile_format!="json") throw invalid_argument(string("Unknown profile format ")+optarg);
+					break;
+				default:
+					usage();
+					return 1;
+			}
+		}
+		if (argc-optind<1) {
+			usage();
+			return 1;
+		}
+		ifstream ifs;
+		Profile profile;
+		Profile *measured=profile_format.empty()?nullptr:&profile;
+		auto print_profile=[&]() {
+			if (profile_format=="text") profile.print(cerr);
+			else if (profile_format=="json") cerr << profile_record(profile) << '\n';
+		};
+		auto open_input=[&]() {
+			if (argc-optind>1 && !(batch && input==Input::FILES)) {
+				ifs.open(argv[optind+1],ifstream::binary);
+				if (!ifs) throw runtime_error(string("Unable to open ")+argv[optind+1]);
+				cin.rdbuf(ifs.rdbuf());
+			}
+		};
+		if (batch || !socket_path.empty()) {
+			Dictionary dict=[&]() {
+				Profile::Scope scope(measured,Stage::LOAD);
+				return Dictionary(argv[optind],method);
+			}();
+			open_input();
+			unique_ptr<Thread_pool> pool;
+			if (threads>1) {
+				pool=make_unique<Thread_pool>(threads-1);
+				parameters.pool=pool.get();
+			}
+			if (!socket_path.empty()) {
+				Server server(socket_path,dict,window_size,parameters,jobs,max_iterations);
+				running_server=&server;
+				signal(SIGINT,stop_server);
+				signal(SIGTERM,stop_server);
+				server.run();
+				running_server=nullptr;
+				return 0;
+			}
+			// The dictionary is loaded once and shared by all the documents
+			auto reader=(input==Input::FILES)?Document_reader(vector<string>(argv+optind+1,argv+argc)):Document_reader(cin,input);
+			Pipeline pipeline(dict,window_size,parameters,stats,measured!=nullptr,jobs,0,batch_size);
+			auto failed=pipeline.run(reader,cout);
+			profile+=pipeline.profile();
+			print_profile();
+			return failed>0?1:0;
+		}
+		// A single text is processed through the C interface of the library, as in any program which embeds it. The enumerations of both interfaces have the same values
+		textrank_dictionary *dictionary=nullptr;
+		{
+			Profile::Scope scope(measured,Stage::LOAD);
+			check(textrank_dictionary_open(argv[optind],textrank_lookup(method),&dictionary));
+		}
+		unique_ptr<textrank_dictionary,void(*)(textrank_dictionary*)> dictionary_owner(dictionary,textrank_dictionary_close);
+		open_input();
+		textrank_extractor *extractor=nullptr;
+		check(textrank_extractor_create(dictionary,threads,&extractor));
+		unique_ptr<textrank_extractor,void(*)(textrank_extractor*)> extractor_owner(extractor,textrank_extractor_destroy);
+		textrank_parameters text_parameters;
+		textrank_default_parameters(&text_parameters);
+		text_parameters.keywords=parameters.num_keywords;
+		text_parameters.window=window_size;
+		text_parameters.sentences=max_sentences;
+		text_parameters.iterations=parameters.max_iterations;
+		text_parameters.damping=parameters.damping;
+		text_parameters.tolerance=parameters.tolerance;
+		text_parameters.norm=textrank_norm(parameters.norm);
+		text_parameters.precision=textrank_precision(parameters.precision);
+		text_parameters.kernel=textrank_kernel(parameters.kernel);
+		text_parameters.solver=textrank_solver(parameters.solver);
+		text_parameters.warm_start=parameters.warm_start;
+		text_parameters.profile=(measured!=nullptr);
+		check(textrank_begin(extractor,&text_parameters));
+		// The text is read by chunks, so that the memory does not depend on its length
+		auto on_sentence=(snapshot>0)?print_snapshot:nullptr;
+		vector<char> buffer(65536);
+		while (cin.read(buffer.data(),buffer.size()) || cin.gcount()>0) check(textrank_append(extractor,buffer.data(),cin.gcount(),on_sentence,&snapshot));
+		check(textrank_finish(extractor,on_sentence,&snapshot));
+		textrank_result res;
+		check(textrank_rank(extractor,&res));
+		if (snapshot>0) cout << "# end, " << textrank_sentences(extractor) << " sentences\n";
+		print_keywords(res);
+		if (stats) cerr << "iterations\t" << res.iterations << "\nresidual\t" << res.residual << "\ntraversals\t" << res.traversals << '\n';
+		textrank_profile text_profile;
+		check(textrank_extractor_profile(extractor,&text_profile));
+		for (int i=0;i<STAGES;++i) profile.add(Stage(i),text_profile.wall[i],text_profile.cpu[i]);
+		for (int i=0;i<COUNTERS;++i) profile.count(Counter(i),text_profile.counters[i]);
+		print_profile();
+	} catch (const exception &e) {
+		cerr << e.what() << '\n';
 		return 1;
 	}
-	locale loc("");
-	locale::global(loc);
-	wcout.imbue(locale(loc,new codecvt_utf8<wchar_t>));
-	wifstream ifs;
-	Dictionary dict(argv[1]);
-	if (argc>2) {
-		ifs.open(argv[2]);
-		wcin.rdbuf(ifs.rdbuf());
-	}
-	Graph graph(wcin,dict,3);
-	auto res=graph.text_rank(10,20,0.85);
-	for (const auto &[word,score]:res) {
-		wcout << word << '\t' << score << endl;
-	}
 }
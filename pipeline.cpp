@@ -0,0 +1,161 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  pipeline.cpp
+ *
+ *    Description:  Implementation of the document-parallel extraction of keywords
+ *
+ *        Version:  1.0
+ *        Created:  18/10/2026 14:58:27
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  François Hissel
+ *   Organization:
+ *
+ * =====================================================================================
+ */
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <chrono>
+#include <exception>
+#include "dictionary.h"
+#include "document.h"
+#include "arena.h"
+#include "profile.h"
+#include "word_cache.h"
+#include "graph.h"
+#include "pipeline.h"
+
+using namespace std;
+
+/*********************************************
+ *                Pipeline                   *
+ *********************************************/
+Pipeline::Pipeline(const Dictionary &dic,int window_size,const Rank_parameters &parameters,bool stats,bool profile,int threads,size_t capacity,size_t batch):_dic(dic),_window_size(window_size),_parameters(parameters),_stats(stats),_profile_documents(profile),_batch(max<size_t>(batch,1)),_out(nullptr),_read(0),_written(0),_writing(false),_own_pool(make_unique<Thread_pool>(threads)),_pool(*_own_pool) {
+	if (capacity==0) capacity=4*size_t(_pool.size())*_batch;
+	// A whole batch must fit in the reorder buffer
+	capacity=max(capacity,_batch);
+	_records.resize(capacity);
+	_ready.resize(capacity,false);
+}
+
+Pipeline::Pipeline(const Dictionary &dic,int window_size,const Rank_parameters &parameters,bool stats,bool profile,Thread_pool &pool,size_t capacity,size_t batch):_dic(dic),_window_size(window_size),_parameters(parameters),_stats(stats),_profile_documents(profile),_batch(max<size_t>(batch,1)),_out(nullptr),_read(0),_written(0),_writing(false),_pool(pool) {
+	if (capacity==0) capacity=4*size_t(_pool.size())*_batch;
+	capacity=max(capacity,_batch);
+	_records.resize(capacity);
+	_ready.resize(capacity,false);
+}
+
+void Pipeline::write_records(unique_lock<mutex> &lock) {
+	if (_writing) return;
+	_writing=true;
+	const auto capacity=_records.size();
+	for (;;) {
+		while (_ready[_written%capacity]) {
+			auto slot=_written%capacity;
+			auto record=move(_records[slot]);
+			_ready[slot]=false;
+			++_written;
+			lock.unlock();
+			*_out << record;
+			lock.lock();
+		}
+		lock.unlock();
+		_out->flush();
+		lock.lock();
+		// Another worker may have finished the next record while the stream was flushed
+		if (!_ready[_written%capacity]) break;
+	}
+	_writing=false;
+	_condition.notify_all();
+}
+
+void Pipeline::process(const vector<shared_ptr<Document>> &docs,size_t slot) {
+	// Each worker keeps its arena from one batch to the next, so that the words of the documents do not call the system allocator, and its cache, so that the frequent words are only looked up in the dictionary once
+	thread_local Arena arena;
+	thread_local Word_cache cache;
+	auto count=docs.size();
+	vector<Ranking> res(count);
+	vector<Timing> timing(count);
+	vector<Profile> profiles(count);
+	// The documents are ranked one by one: each graph is ranked as soon as it is built, while it is still in the caches of the processor. Ranking the graphs of the batch together with Graph::text_rank_batch is slower, because the packed matrix is read again from memory at each iteration
+	for (size_t i=0;i<count;++i) {
+		auto &doc=*docs[i];
+		if (!doc.error.empty()) continue;
+		try {
+			auto start=chrono::steady_clock::now();
+			Graph graph(string_view(doc.text),_dic,doc.window_size,&arena,doc.profile?&profiles[i]:nullptr,&cache);
+			auto built=chrono::steady_clock::now();
+			res[i]=graph.text_rank(doc.parameters);
+			auto ranked=chrono::steady_clock::now();
+			timing[i].graph=chrono::duration<double,milli>(built-start).count();
+			timing[i].rank=chrono::duration<double,milli>(ranked-built).count();
+		} catch (const exception &e) {
+			doc.error=e.what();
+		}
+		arena.reset();
+	}
+	vector<string> records(count);
+	for (size_t i=0;i<count;++i) {
+		ostringstream record;
+		record << result_record(*docs[i],res[i],_stats,timing[i],profiles[i]) << '\n';
+		records[i]=record.str();
+	}
+	unique_lock<mutex> lock(_mutex);
+	const auto capacity=_records.size();
+	for (size_t i=0;i<count;++i) {
+		if (docs[i]->profile) _profile+=profiles[i];
+		_records[(slot+i)%capacity]=move(records[i]);
+		_ready[(slot+i)%capacity]=true;
+	}
+	write_records(lock);
+}
+
+size_t Pipeline::run(Document_reader &reader,ostream &out) {
+	const auto capacity=_records.size();
+	size_t failed=0;
+	_out=&out;
+	_read=0;
+	_written=0;
+	vector<shared_ptr<Document>> batch;
+	size_t slot=0;
+	size_t text=0;
+	auto submit=[&]() {
+		if (batch.empty()) return;
+		_pool.submit([this,docs=move(batch),slot]() {process(docs,slot);});
+		batch.clear();
+		text=0;
+		// Wait until the next batch fits in the reorder buffer
+		unique_lock<mutex> lock(_mutex);
+		_condition.wait(lock,[&]{return _read-_written+_batch<=capacity;});
+	};
+	for (;;) {
+		auto doc=make_shared<Document>();
+		doc->window_size=_window_size;
+		doc->parameters=_parameters;
+		doc->profile=_profile_documents;
+		if (!reader.next(*doc)) break;
+		if (!doc->error.empty()) ++failed;
+		if (text+doc->text.size()>BATCH_TEXT) submit();
+		{
+			lock_guard<mutex> lock(_mutex);
+			if (batch.empty()) slot=_read%capacity;
+			++_read;
+		}
+		text+=doc->text.size();
+		batch.push_back(move(doc));
+		if (batch.size()>=_batch || text>=BATCH_TEXT) submit();
+	}
+	submit();
+	unique_lock<mutex> lock(_mutex);
+	_condition.wait(lock,[&]{return _written==_read && !_writing;});
+	return failed;
+}
@@ -0,0 +1,132 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  pipeline.h
+ *
+ *    Description:  Document-parallel extraction of keywords, with the results written
+ *    				in the order of the input
+ *
+ *        Version:  1.0
+ *        Created:  18/10/2026 14:36:12
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  François Hissel
+ *   Organization:
+ *
+ * =====================================================================================
+ */
+
+#ifndef  PIPELINE_INC
+#define  PIPELINE_INC
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <cstddef>
+#include "profile.h"
+#include "graph.h"
+#include "thread_pool.h"
+
+class Dictionary;
+class Document_reader;
+struct Document;
+
+/**
+ * \brief Largest total size of the texts of the documents of a batch, in bytes. Longer documents are processed one by one, so that the workers still share the work when there are few of them
+ */
+constexpr std::size_t BATCH_TEXT=1<<16;
+
+/**
+ * \brief Document-parallel extraction of keywords
+ *
+ * The calling thread reads the documents and hands them to a pool of workers, by batches of consecutive documents. The workers share the read-only dictionary, each one builds and ranks the graphs of the documents of its batch one after the other, which saves the dispatch of each short document to a worker. Records are written back in the order of the input through a reorder buffer, by the worker which finishes the oldest pending document, so that a record is sent as soon as all the previous ones are. The number of documents in flight, read but not yet written, is bounded by the capacity of the buffer, so the memory footprint does not depend on the length of the input.
+ */
+class Pipeline {
+	public:
+		/**
+		 * \brief Create the pipeline with its own pool of workers
+		 *
+		 * \param dic Dictionary shared by all the workers
+		 * \param window_size Default size of the window for linked edges
+		 * \param parameters Default parameters of the TextRank algorithm
+		 * \param stats Add the number of iterations, the final residual and the time spent to the records
+		 * \param profile Default choice to measure the stages of each document and add their time and counters to its record
+		 * \param threads Number of worker threads. If it is 0, the number of hardware threads is used
+		 * \param capacity Maximal number of documents in flight. If it is 0, four times the number of documents of the batches of all the workers is used
+		 * \param batch Largest number of documents of a batch, whose texts are at most BATCH_TEXT bytes long in total
+		 */
+		Pipeline(const Dictionary &dic,int window_size,const Rank_parameters &parameters,bool stats,bool profile,int threads=0,std::size_t capacity=0,std::size_t batch=1);
+
+		/**
+		 * \brief Create the pipeline on a pool of workers shared with other pipelines
+		 *
+		 * \param dic Dictionary shared by all the workers
+		 * \param window_size Default size of the window for linked edges
+		 * \param parameters Default parameters of the TextRank algorithm
+		 * \param stats Add the number of iterations, the final residual and the time spent to the records
+		 * \param profile Default choice to measure the stages of each document and add their time and counters to its record
+		 * \param pool Pool of workers, which must outlive the pipeline
+		 * \param capacity Maximal number of documents in flight. If it is 0, four times the number of documents of the batches of all the workers is used
+		 * \param batch Largest number of documents of a batch, whose texts are at most BATCH_TEXT bytes long in total. Batches are only submitted when they are full, so that a server waiting for the next request of a client must use batches of a single document
+		 */
+		Pipeline(const Dictionary &dic,int window_size,const Rank_parameters &parameters,bool stats,bool profile,Thread_pool &pool,std::size_t capacity=0,std::size_t batch=1);
+
+		/**
+		 * \brief Extract the keywords of all the documents of a batch
+		 *
+		 * The window size and parameters given to the constructor may be overridden by each document.
+		 * \param reader Reader of the documents
+		 * \param out Output stream of the records, one JSON object per line and per document. The stream is flushed each time the workers have no more record to write
+		 * \return Number of documents which could not be read
+		 */
+		std::size_t run(Document_reader &reader,std::ostream &out);
+
+		/**
+		 * \brief Sum of the profiles of the documents whose stages were measured since the pipeline was created
+		 *
+		 * The function must not be called while the pipeline runs.
+		 */
+		const Profile &profile() const noexcept {return _profile;}
+
+	private:
+		const Dictionary &_dic; 	//!< Dictionary shared by the workers
+		int _window_size; 	//!< Default size of the window for linked edges
+		Rank_parameters _parameters; 	//!< Default parameters of the TextRank algorithm
+		bool _stats; 	//!< Add the statistics of the iterations to the records
+		bool _profile_documents; 	//!< Default choice to measure the stages of each document
+		std::size_t _batch; 	//!< Largest number of documents of a batch
+		Profile _profile; 	//!< Sum of the profiles of the documents
+		std::vector<std::string> _records; 	//!< Reorder buffer: the record of document i is stored in slot i modulo the capacity
+		std::vector<bool> _ready; 	//!< Tell if the record of each slot is finished
+		std::ostream *_out; 	//!< Output stream of the current run
+		std::size_t _read; 	//!< Number of documents read during the current run
+		std::size_t _written; 	//!< Number of records written during the current run
+		bool _writing; 	//!< Tell if a worker is currently writing records
+		std::mutex _mutex; 	//!< Mutex protecting the reorder buffer and the counters
+		std::condition_variable _condition; 	//!< Condition signalled when records are written
+		std::unique_ptr<Thread_pool> _own_pool; 	//!< Pool created by the pipeline, if it does not share one. Declared last, so that its workers are joined before the reorder buffer is destroyed
+		Thread_pool &_pool; 	//!< Workers
+
+		/**
+		 * \brief Write the records which follow the last written one and are finished
+		 *
+		 * Only one thread writes at a time. The function must be called with the mutex locked, which is released while writing.
+		 * \param lock Lock on the mutex
+		 */
+		void write_records(std::unique_lock<std::mutex> &lock);
+
+		/**
+		 * \brief Extract the keywords of a batch of documents and store their records in the reorder buffer
+		 *
+		 * The function is run by a worker.
+		 * \param docs Documents of the batch
+		 * \param slot Slot of the record of the first document, the next ones following it
+		 */
+		void process(const std::vector<std::shared_ptr<Document>> &docs,std::size_t slot);
+};
+
+#endif   /* ----- #ifndef PIPELINE_INC  ----- */
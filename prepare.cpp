@@ -11,7 +11,7 @@
  *       Compiler:  g++
  *
  *         Author:  François Hissel
- *   Organization:  
+ *   Organization:
  *
  * =====================================================================================
  */
@@ -19,98 +19,490 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <array>
-#include <unordered_map>
+#include <deque>
 #include <algorithm>
-#include <iterator>
-#include <utility>
+#include <memory>
+#include <thread>
+#include <stdexcept>
+#include <charconv>
+#include <cstring>
+#include <cstddef>
+#include <cerrno>
+#include <limits>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "format.h"
+#include "thread_pool.h"
 
 using namespace std;
 
 /**
- * \brief Next token in a tab-separated value file
+ * \brief Text file mapped read-only in memory
+ */
+class Mapped_file {
+	public:
+		/**
+		 * \brief Map a file
+		 *
+		 * \param path Path name of the file
+		 * \throw std::runtime_error if the file can not be mapped
+		 */
+		explicit Mapped_file(const string &path):_data(nullptr),_length(0) {
+			int fd=open(path.c_str(),O_RDONLY);
+			if (fd<0) throw runtime_error("Unable to open "+path+": "+strerror(errno));
+			struct stat st;
+			if (fstat(fd,&st)<0) {
+				close(fd);
+				throw runtime_error("Unable to read "+path+": "+strerror(errno));
+			}
+			_length=st.st_size;
+			if (_length>0) {
+				void *data=mmap(nullptr,_length,PROT_READ,MAP_PRIVATE,fd,0);
+				if (data==MAP_FAILED) {
+					close(fd);
+					throw runtime_error("Unable to map "+path+": "+strerror(errno));
+				}
+				_data=static_cast<const char*>(data);
+				// The file is read once from the beginning to the end
+				madvise(data,_length,MADV_SEQUENTIAL);
+			}
+			close(fd);
+		}
+
+		Mapped_file(const Mapped_file&)=delete; 	//!< The mapping can not be copied
+		Mapped_file& operator=(const Mapped_file&)=delete; 	//!< The mapping can not be copied
+
+		/**
+		 * \brief Unmap the file
+		 */
+		~Mapped_file() {
+			if (_data!=nullptr) munmap(const_cast<char*>(_data),_length);
+		}
+
+		/**
+		 * \brief Content of the file
+		 */
+		string_view content() const noexcept {return string_view(_data,_length);}
+
+	private:
+		const char *_data; 	//!< Start of the mapping
+		size_t _length; 	//!< Size of the file
+};
+
+/**
+ * \brief Entry of the text dictionary
+ *
+ * The strings point into the mapped input file.
+ */
+struct Text_entry {
+	string_view word; 	//!< Word
+	char pos; 	//!< POS tag, either 'N' for nouns, 'A' for adjectives, 'S' for the other words and ' ' if it is unknown
+	string_view lemma; 	//!< Lemma of the word, empty if it is not given
+	double frequency; 	//!< Frequency of the word, 0 if it is not given
+	bool has_frequency; 	//!< Tell if the frequency is given
+};
+
+/**
+ * \brief Index of the distinct words of the dictionary
  *
- * This function returns the substring of string s starting at position pos and up to the next tabulation character or the end of the string. The value pos is updated to the position after the tabulation character.
- * \param s Source string
+ * The index is an open-addressing hash table with linear probing, which stores the number of each word in a vector. It is much faster than a node-based map for tens of millions of words.
+ */
+class Word_index {
+	public:
+		/**
+		 * \brief Create an empty index
+		 *
+		 * \param words Words of the index, which must outlive it. The index is kept up to date by calling insert each time a word is added to the end of the vector
+		 * \param capacity Expected number of words
+		 */
+		Word_index(const vector<Text_entry> &words,size_t capacity):_words(words),_count(0) {
+			size_t size=16;
+			while (size<2*capacity) size*=2;
+			_slots.assign(size,0);
+		}
+
+		/**
+		 * \brief Find a word
+		 *
+		 * \param word Word
+		 * \return Number of the word in the vector, or -1 if it is not in the index
+		 */
+		int64_t find(string_view word) const noexcept {
+			auto mask=_slots.size()-1;
+			for (auto i=hash_word(word)&mask;_slots[i]!=0;i=(i+1)&mask) if (_words[_slots[i]-1].word==word) return _slots[i]-1;
+			return -1;
+		}
+
+		/**
+		 * \brief Add the last word of the vector to the index
+		 *
+		 * The word must not be in the index yet.
+		 */
+		void insert() {
+			if (2*(_count+1)>_slots.size()) {
+				// Keep the load factor under 1/2
+				_slots.assign(2*_slots.size(),0);
+				for (uint32_t i=0;i<_count;++i) place(i);
+			}
+			place(_count++);
+		}
+
+	private:
+		const vector<Text_entry> &_words; 	//!< Indexed words
+		vector<uint32_t> _slots; 	//!< Number of the word of each slot plus 1, 0 for the empty slots
+		uint32_t _count; 	//!< Number of words in the index
+
+		/**
+		 * \brief Store a word in the first free slot of its probe sequence
+		 *
+		 * \param i Number of the word
+		 */
+		void place(uint32_t i) noexcept {
+			auto mask=_slots.size()-1;
+			auto j=hash_word(_words[i].word)&mask;
+			while (_slots[j]!=0) j=(j+1)&mask;
+			_slots[j]=i+1;
+		}
+};
+
+/**
+ * \brief Next token in a tab-separated value line
+ *
+ * This function returns the substring of the line starting at position pos and up to the next tabulation character or the end of the line. The value pos is updated to the position after the tabulation character.
+ * \param s Line
  * \param pos Starting position
- * \return Next token, extracted from string s up to the next tabulation character or the end of the string
+ * \return Next token, extracted from the line up to the next tabulation character or the end of the line
  */
-string next_token(const string &s,string::size_type &pos) {
+string_view next_token(string_view s,string_view::size_type &pos) {
+	if (pos>=s.length()) return string_view();
 	auto i=pos;
-	pos=s.find_first_of('\t',i);
-	if (pos==string::npos) pos=s.length();
+	pos=s.find('\t',i);
+	if (pos==string_view::npos) pos=s.length();
 	return s.substr(i,(pos++)-i);
 }
 
 /**
- * \brief Tell if an entry of the dictionary is not needed.
+ * \brief Read the entries of the text dictionary
  *
- * This function tests for unneeded entries in the resulting dictionary. Currently, nouns and adjectives without associated lemma are unneeded because a word with no POS tag is considered the same.
+ * Each line holds a word, its POS tag, its lemma and its frequency, separated by tabulations. When a word appears several times, the entry with a frequency is preferred to the one without, then the entry with the highest frequency, and an entry with a lemma replaces an entry without POS tag.
+ * \param content Content of the text dictionary
+ * \param entries Distinct entries, in the order of their first occurrence
+ * \param index Index of the words of the entries, which must be empty
+ * \throw std::runtime_error if a frequency is not a number
  */
-inline bool unused(const tuple<string,string,string,int32_t> &ent) {
-	return (get<1>(ent)=="N" || get<1>(ent)=="A") && get<3>(ent)==-1;
+void read_entries(string_view content,vector<Text_entry> &entries,Word_index &index) {
+	size_t number=0;
+	while (!content.empty()) {
+		auto end=content.find('\n');
+		auto line=content.substr(0,end);
+		content.remove_prefix((end==string_view::npos)?content.size():end+1);
+		++number;
+		if (!line.empty() && line.back()=='\r') line.remove_suffix(1);
+		string_view::size_type i=0;
+		Text_entry entry;
+		entry.word=next_token(line,i);
+		auto pos=next_token(line,i);
+		entry.lemma=next_token(line,i);
+		auto freq=next_token(line,i);
+		if (entry.word.empty()) continue;
+		if (pos=="NOM") entry.pos='N';
+		else if (pos=="ADJ") entry.pos='A';
+		else if (pos.empty()) entry.pos=' ';
+		else entry.pos='S';
+		entry.frequency=0.0;
+		entry.has_frequency=!freq.empty();
+		if (entry.has_frequency) {
+			auto res=from_chars(freq.data(),freq.data()+freq.size(),entry.frequency);
+			if (res.ec!=errc()) throw runtime_error("Invalid frequency on line "+to_string(number)+": "+string(freq));
+		}
+		auto found=index.find(entry.word);
+		if (found<0) {
+			if (entries.size()>=size_t(numeric_limits<int32_t>::max())) throw runtime_error("Too many words in the dictionary");
+			entries.push_back(entry);
+			index.insert();
+		} else {
+			auto &old=entries[found];
+			if ((!old.has_frequency && entry.has_frequency) || (old.has_frequency && old.frequency<entry.frequency) || (old.pos==' ' && !entry.lemma.empty())) old=entry;
+		}
+	}
 }
 
-int main(int argc,char *argv[]) {
-	ifstream ifs(argv[1]);
-	unordered_map<string,array<string,3>> dic;
-	string word,pos,lemma,freq;
-	double dfreq;
-	string line;
-	while (ifs) {
-		getline(ifs,line);
-		if (ifs.fail() || ifs.bad()) continue;
-		string::size_type i=0;
-		word=next_token(line,i);
-		pos=next_token(line,i);
-		lemma=next_token(line,i);
-		freq=next_token(line,i);
-		if (freq!="") dfreq=stod(freq); else dfreq=0.0;
-		if (pos=="NOM") pos="N";
-		else if (pos=="ADJ") pos="A";
-		else if (pos=="") pos="";
-		else pos="S";
-		auto it=dic.find(word);
-		if (it==dic.end()) {  
-			dic.insert(make_pair(word,array<string,3>{pos,lemma,freq}));
+/**
+ * \brief First 8 bytes of a word as a big-endian integer, padded with zeros
+ *
+ * Comparing the prefixes of two words gives the byte order of the words, unless the prefixes are equal.
+ * \param word Word
+ * \return Prefix of the word
+ */
+inline uint64_t word_prefix(string_view word) noexcept {
+	uint64_t res=0;
+	for (size_t i=0;i<8;++i) res=(res<<8)|((i<word.size())?uint8_t(word[i]):0);
+	return res;
+}
+
+/**
+ * \brief Sort a vector, in parallel if a pool of threads is given
+ *
+ * The vector is split in chunks sorted by different threads, which are then merged pairwise. The order of equal elements is not specified, so the comparison should be a total order for the result to be deterministic.
+ * \param v Vector
+ * \param comp Comparison function
+ * \param pool Pool of threads sharing the sort with the calling thread, or nullptr to sort in the calling thread
+ */
+template<class T,class Compare> void parallel_sort(vector<T> &v,Compare comp,Thread_pool *pool) {
+	int chunks=(pool==nullptr)?1:int(min<size_t>(pool->size()+1,v.size()/65536+1));
+	if (chunks==1) {
+		sort(v.begin(),v.end(),comp);
+		return;
+	}
+	vector<size_t> bounds(chunks+1);
+	for (int c=0;c<=chunks;++c) bounds[c]=v.size()*c/chunks;
+	pool->parallel_for(chunks,[&](int c) {sort(v.begin()+bounds[c],v.begin()+bounds[c+1],comp);});
+	for (int width=1;width<chunks;width*=2) {
+		int merges=(chunks+2*width-1)/(2*width);
+		pool->parallel_for(merges,[&](int m) {
+			auto first=bounds[2*m*width];
+			auto middle=bounds[min(chunks,(2*m+1)*width)];
+			auto last=bounds[min(chunks,(2*m+2)*width)];
+			inplace_merge(v.begin()+first,v.begin()+middle,v.begin()+last,comp);
+		});
+	}
+}
+
+/**
+ * \brief Build the minimal perfect hash table of the dictionary
+ *
+ * The function uses the hash and displace method. Words are distributed in buckets of about 4 words. Buckets are then processed from the largest to the smallest, and for each bucket the first displacement which sends all its words to free slots is stored.
+ * \param keys List of distinct keys
+ * \param displacements Resulting displacement of each bucket
+ * \param slots Resulting hash table, with exactly one slot per key, which holds the index of the key
+ * \return True if the table could be built, false otherwise
+ */
+bool build_hash(const vector<string_view> &keys,vector<uint32_t> &displacements,vector<Hash_slot> &slots) {
+	uint32_t n=keys.size();
+	uint32_t nb=n/4+1;
+	vector<uint64_t> hashes;
+	hashes.reserve(n);
+	for (const auto &it:keys) hashes.push_back(hash_word(it));
+	// Keys of each bucket, in increasing order, stored contiguously: bucket b is made of the elements [starts[b],starts[b+1]) of members
+	vector<uint32_t> starts(nb+1,0);
+	for (uint32_t i=0;i<n;++i) ++starts[hash_bucket(hashes[i],nb)+1];
+	for (uint32_t b=0;b<nb;++b) starts[b+1]+=starts[b];
+	vector<uint32_t> members(n);
+	vector<uint32_t> fill(starts.begin(),starts.end()-1);
+	for (uint32_t i=0;i<n;++i) members[fill[hash_bucket(hashes[i],nb)]++]=i;
+	vector<uint32_t> order(nb);
+	for (uint32_t i=0;i<nb;++i) order[i]=i;
+	stable_sort(order.begin(),order.end(),[&starts](uint32_t a,uint32_t b){return starts[a+1]-starts[a]>starts[b+1]-starts[b];});
+	displacements.assign(nb,0);
+	slots.assign(n,Hash_slot{0,0});
+	vector<bool> used(n,false);
+	vector<uint32_t> positions;
+	for (auto b:order) {
+		auto first=members.begin()+starts[b];
+		auto last=members.begin()+starts[b+1];
+		if (first==last) break;
+		uint32_t d=0;
+		for (;;++d) {
+			if (d==numeric_limits<uint32_t>::max()) return false;
+			positions.clear();
+			bool ok=true;
+			for (auto it=first;it!=last;++it) {
+				auto p=hash_position(hashes[*it],d,n);
+				if (used[p] || find(positions.begin(),positions.end(),p)!=positions.end()) {ok=false;break;}
+				positions.push_back(p);
+			}
+			if (ok) break;
 		}
-		else if ((it->second[2]=="" && freq!="") || (it->second[2]!="" && stod(it->second[2])<dfreq) || (it->second[0]=="" && lemma!="")) {
-			it->second[0]=pos;
-			it->second[1]=lemma;
-			it->second[2]=freq;
+		displacements[b]=d;
+		for (size_t k=0;k<positions.size();++k) {
+			used[positions[k]]=true;
+			slots[positions[k]]=Hash_slot{first[k],hash_fingerprint(hashes[first[k]])};
 		}
 	}
-	vector<tuple<string,string,string,int32_t>> words;
-	transform(dic.begin(),dic.end(),back_inserter(words),[](const auto &a){return make_tuple(a.first,move(a.second[0]),move(a.second[1]),0);});
-	words.erase(remove_if(words.begin(),words.end(),unused));
-	sort(words.begin(),words.end(),[](const auto &a,const auto &b){return get<0>(a)<get<0>(b);});
-	for (auto &it:words) {
-		if (get<1>(it)!="N" && get<1>(it)!="A" && get<2>(it)!="") {
-			auto val=make_tuple(get<2>(it),"","",0);
-			auto f=lower_bound(words.begin(),words.end(),val);
-			if (f!=words.end()) get<3>(it)=distance(words.begin(),f);
-		} else get<3>(it)=-1;
+	return true;
+}
+
+/**
+ * \brief Append an integer to a buffer, in little-endian byte order
+ *
+ * \param buffer Buffer
+ * \param v Integer
+ */
+template<class T> void append(vector<char> &buffer,T v) {
+	v=little_endian(v);
+	auto bytes=reinterpret_cast<const char*>(&v);
+	buffer.insert(buffer.end(),bytes,bytes+sizeof(T));
+}
+
+/**
+ * \brief Append a slot of a perfect hash table to a buffer, in little-endian byte order
+ *
+ * \param buffer Buffer
+ * \param slot Slot
+ */
+void append(vector<char> &buffer,const Hash_slot &slot) {
+	append(buffer,slot.entry);
+	append(buffer,slot.fingerprint);
+}
+
+/**
+ * \brief Append a byte to a buffer
+ *
+ * \param buffer Buffer
+ * \param c Byte
+ */
+void append(vector<char> &buffer,char c) {buffer.push_back(c);}
+
+/**
+ * \brief Append the bytes of a string to a buffer
+ *
+ * \param buffer Buffer
+ * \param s String
+ */
+void append(vector<char> &buffer,string_view s) {buffer.insert(buffer.end(),s.begin(),s.end());}
+
+/**
+ * \brief Append a section to the binary dictionary
+ *
+ * The section is aligned on SECTION_ALIGNMENT bytes, and its location and checksum are stored in the header.
+ * \param buffer Content of the file, starting with the header
+ * \param header Header of the file
+ * \param section Section
+ * \param data Elements of the section
+ */
+template<class T> void append_section(vector<char> &buffer,Dictionary_header &header,Section section,const vector<T> &data) {
+	buffer.resize((buffer.size()+SECTION_ALIGNMENT-1)/SECTION_ALIGNMENT*SECTION_ALIGNMENT,0);
+	auto offset=buffer.size();
+	for (const auto &it:data) append(buffer,it);
+	auto &entry=header.sections[int(section)];
+	entry.offset=little_endian(uint64_t(offset));
+	entry.size=little_endian(uint64_t(buffer.size()-offset));
+	entry.checksum=little_endian(checksum(buffer.data()+offset,buffer.size()-offset));
+}
+
+/**
+ * \brief Main program
+ *
+ * \param argc Number of command-line arguments, including the name of the program
+ * \param argv Array or command-line arguments, the first element is the name of the program
+ * \return 0 if the execution was successful, an error code otherwise
+ */
+int main(int argc,char *argv[]) {
+	if (argc<3) {
+		cerr << "Syntax: prepare path_to_text_dictionary path_to_binary_dictionary\n";
+		return 1;
 	}
-	ofstream ofs(argv[2],ofstream::binary);
-	for (auto &it:words) {
-		char a;
-		if (get<1>(it)!="") a=get<1>(it)[0]; else a=' ';
-		ofs.write(&a,1);
-		ofs.write((char*)(&(get<3>(it))),sizeof(int32_t));
-		wstring::size_type l=get<0>(it).length();
-		unsigned char b=(unsigned char)(l);
-		ofs.write((char*)(&b),sizeof(unsigned char));
-		ofs.write(get<0>(it).data(),sizeof(char)*l);
+	try {
+		unique_ptr<Thread_pool> pool;
+		auto threads=thread::hardware_concurrency();
+		if (threads>1) pool=make_unique<Thread_pool>(threads-1);
+		Mapped_file input(argv[1]);
+		vector<Text_entry> entries;
+		// Lines have about 30 bytes, so that the index is seldom rebuilt
+		Word_index index(entries,input.content().size()/30);
+		read_entries(input.content(),entries,index);
+		// Sort the entries by byte order of their words, which are distinct. The first bytes of the words are compared as integers, and the words themselves only when they are equal
+		vector<pair<uint64_t,uint32_t>> sorted(entries.size());
+		for (uint32_t i=0;i<entries.size();++i) sorted[i]=make_pair(word_prefix(entries[i].word),i);
+		parallel_sort(sorted,[&entries](const auto &a,const auto &b){return a.first<b.first || (a.first==b.first && entries[a.second].word<entries[b.second].word);},pool.get());
+		vector<uint32_t> order(entries.size());
+		vector<uint32_t> rank(entries.size());
+		for (uint32_t i=0;i<sorted.size();++i) {
+			order[i]=sorted[i].second;
+			rank[order[i]]=i;
+		}
+		sorted=vector<pair<uint64_t,uint32_t>>();
+		// Words which are neither nouns nor adjectives are linked to the entry of their lemma, if it is in the dictionary
+		vector<int32_t> lemmas(entries.size(),-1);
+		for (uint32_t i=0;i<order.size();++i) {
+			const auto &entry=entries[order[i]];
+			if (entry.pos=='N' || entry.pos=='A' || entry.lemma.empty()) continue;
+			auto found=index.find(entry.lemma);
+			if (found>=0) lemmas[i]=rank[found];
+		}
+		vector<string_view> keys;
+		keys.reserve(entries.size());
+		for (auto i:order) keys.push_back(entries[i].word);
+		vector<uint32_t> displacements;
+		vector<Hash_slot> slots;
+		if (!keys.empty() && !build_hash(keys,displacements,slots)) throw runtime_error("Unable to build the perfect hash table");
+		// Group the entries by case-folded word, and build the perfect hash table of the folded words. Only the words with upper-case letters need a folded copy
+		deque<string> copies;
+		vector<string_view> folded;
+		folded.reserve(keys.size());
+		for (const auto &it:keys) {
+			if (none_of(it.begin(),it.end(),[](char c){return c!=fold_char(c);})) folded.push_back(it);
+			else {
+				copies.emplace_back(it);
+				transform(copies.back().begin(),copies.back().end(),copies.back().begin(),fold_char);
+				folded.push_back(copies.back());
+			}
+		}
+		vector<uint32_t> fold_order(keys.size());
+		for (uint32_t i=0;i<fold_order.size();++i) fold_order[i]=i;
+		parallel_sort(fold_order,[&folded](uint32_t a,uint32_t b){return folded[a]<folded[b] || (folded[a]==folded[b] && a<b);},pool.get());
+		vector<uint32_t> fold_groups;
+		vector<int32_t> fold_lower;
+		vector<string_view> fold_keys;
+		for (uint32_t i=0;i<fold_order.size();++i) {
+			auto e=fold_order[i];
+			if (i==0 || folded[e]!=folded[fold_order[i-1]]) {
+				fold_groups.push_back(i);
+				fold_lower.push_back(-1);
+				fold_keys.push_back(folded[e]);
+			}
+			if (folded[e]==keys[e]) fold_lower.back()=e;
+		}
+		fold_groups.push_back(fold_order.size());
+		vector<uint32_t> fold_displacements;
+		vector<Hash_slot> fold_slots;
+		if (!fold_keys.empty() && !build_hash(fold_keys,fold_displacements,fold_slots)) throw runtime_error("Unable to build the perfect hash table of folded words");
+		// Build the whole file in memory and write it at once
+		vector<uint32_t> offsets;
+		vector<char> tags(tags_size(keys.size()),0);
+		offsets.reserve(keys.size()+1);
+		uint64_t offset=0;
+		for (size_t i=0;i<keys.size();++i) {
+			offsets.push_back(uint32_t(offset));
+			offset+=keys[i].length();
+			tags[i]=entries[order[i]].pos;
+		}
+		if (offset>numeric_limits<uint32_t>::max()) throw runtime_error("The words of the dictionary are too long");
+		offsets.push_back(uint32_t(offset));
+		Dictionary_header header;
+		memset(&header,0,sizeof(header));
+		memcpy(header.magic,DICTIONARY_MAGIC,sizeof(DICTIONARY_MAGIC));
+		header.version=little_endian(DICTIONARY_VERSION);
+		header.count=little_endian(uint32_t(keys.size()));
+		header.pool_size=little_endian(uint32_t(offset));
+		header.hash_buckets=little_endian(uint32_t(displacements.size()));
+		header.groups=little_endian(uint32_t(fold_keys.size()));
+		header.fold_buckets=little_endian(uint32_t(fold_displacements.size()));
+		vector<char> buffer(sizeof(header));
+		buffer.reserve(sizeof(header)+(offsets.size()+lemmas.size()+displacements.size()+fold_order.size()+fold_groups.size()+fold_lower.size()+fold_displacements.size())*4+(slots.size()+fold_slots.size())*sizeof(Hash_slot)+tags.size()+offset+SECTIONS*SECTION_ALIGNMENT);
+		append_section(buffer,header,Section::OFFSETS,offsets);
+		append_section(buffer,header,Section::LEMMAS,lemmas);
+		append_section(buffer,header,Section::TAGS,tags);
+		append_section(buffer,header,Section::DISPLACEMENTS,displacements);
+		append_section(buffer,header,Section::SLOTS,slots);
+		append_section(buffer,header,Section::FOLD_ORDER,fold_order);
+		append_section(buffer,header,Section::FOLD_GROUPS,fold_groups);
+		append_section(buffer,header,Section::FOLD_LOWER,fold_lower);
+		append_section(buffer,header,Section::FOLD_DISPLACEMENTS,fold_displacements);
+		append_section(buffer,header,Section::FOLD_SLOTS,fold_slots);
+		append_section(buffer,header,Section::POOL,keys);
+		header.checksum=little_endian(checksum(reinterpret_cast<const char*>(&header),offsetof(Dictionary_header,checksum)));
+		memcpy(buffer.data(),&header,sizeof(header));
+		ofstream ofs(argv[2],ofstream::binary);
+		ofs.write(buffer.data(),buffer.size());
+		ofs.close();
+		if (!ofs) throw runtime_error(string("Unable to write ")+argv[2]);
+	} catch (const exception &e) {
+		cerr << e.what() << '\n';
+		return 1;
 	}
-//	for (auto &it:words) {
-//		char a;
-//		if (get<1>(it)=="N") a='N';
-//		else if (get<1>(it)=="A") a='A';
-//		else if (get<1>(it)=="") a=' ';
-//		else if (get<1>(it)=="S") a='S';
-//		cout << a << "\t" << get<3>(it) << "\t";
-//		wstring::size_type l=get<0>(it).length();
-//		cout << l << "\t" << get<0>(it) << endl;
-//	}
 }
@@ -0,0 +1,58 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  profile.cpp
+ *
+ *    Description:  Implementation of the profile of the keyword extraction
+ *
+ *        Version:  1.0
+ *        Created:  20/10/2026 10:48:02
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  François Hissel
+ *   Organization:
+ *
+ * =====================================================================================
+ */
+
+#include <iostream>
+#include <iomanip>
+#include "profile.h"
+
+using namespace std;
+
+/*********************************************
+ *           Utility functions               *
+ *********************************************/
+const char *stage_name(Stage stage) noexcept {
+	static const char *names[STAGES]={"load","tokenize","lookup","build","rank","phrases"};
+	return names[int(stage)];
+}
+
+const char *counter_name(Counter counter) noexcept {
+	static const char *names[COUNTERS]={"tokens","hits","misses","folded","cache_hits","cache_misses","sentences","nodes","edges","iterations","traversals"};
+	return names[int(counter)];
+}
+
+/*********************************************
+ *                 Profile                   *
+ *********************************************/
+Profile &Profile::operator+=(const Profile &other) noexcept {
+	for (int i=0;i<STAGES;++i) {
+		_wall[i]+=other._wall[i];
+		_cpu[i]+=other._cpu[i];
+	}
+	for (int i=0;i<COUNTERS;++i) _counters[i]+=other._counters[i];
+	return *this;
+}
+
+void Profile::print(ostream &out) const {
+	auto flags=out.flags();
+	auto precision=out.precision();
+	out << fixed << setprecision(3) << left << setw(12) << "stage" << right << setw(12) << "wall (ms)" << setw(12) << "cpu (ms)" << '\n';
+	for (int i=0;i<STAGES;++i) out << left << setw(12) << stage_name(Stage(i)) << right << setw(12) << _wall[i]*1e3 << setw(12) << _cpu[i]*1e3 << '\n';
+	for (int i=0;i<COUNTERS;++i) out << left << setw(12) << counter_name(Counter(i)) << right << setw(12) << _counters[i] << '\n';
+	out.flags(flags);
+	out.precision(precision);
+}
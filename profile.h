@@ -0,0 +1,198 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  profile.h
+ *
+ *    Description:  Time and counters of the stages of the keyword extraction
+ *
+ *        Version:  1.0
+ *        Created:  20/10/2026 10:12:36
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  François Hissel
+ *   Organization:
+ *
+ * =====================================================================================
+ */
+
+#ifndef  PROFILE_INC
+#define  PROFILE_INC
+
+#include <iostream>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+
+/**
+ * \brief Stage of the keyword extraction
+ */
+enum class Stage {
+	LOAD, 	//!< Loading of the dictionary
+	TOKENIZE, 	//!< Split of the text in words and sentences
+	LOOKUP, 	//!< Lookup of the words in the dictionary
+	BUILD, 	//!< Construction of the nodes and edges of the graph, and of its CSR structure
+	RANK, 	//!< Iterations of the TextRank algorithm
+	PHRASES 	//!< Selection of the keywords and assembly of the multi-word keywords
+};
+
+constexpr int STAGES=6; 	//!< Number of stages
+
+/**
+ * \brief Counter of the keyword extraction
+ */
+enum class Counter {
+	TOKENS, 	//!< Words of the text
+	HITS, 	//!< Words found in the dictionary
+	MISSES, 	//!< Words looked up but not found in the dictionary
+	FOLDED, 	//!< Words only found through their lower-case version
+	CACHE_HITS, 	//!< Lookups served by the cache of the words
+	CACHE_MISSES, 	//!< Lookups which had to read the dictionary
+	SENTENCES, 	//!< Sentences with at least one word
+	NODES, 	//!< Nodes of the graph
+	EDGES, 	//!< Non-directional edges of the graph
+	ITERATIONS, 	//!< Iterations of the TextRank algorithm
+	TRAVERSALS 	//!< Edges read by the iterations of the TextRank algorithm
+};
+
+constexpr int COUNTERS=11; 	//!< Number of counters
+
+/**
+ * \brief Name of a stage
+ *
+ * \param stage Stage
+ * \return Name of the stage, in lower case
+ */
+const char *stage_name(Stage stage) noexcept;
+
+/**
+ * \brief Name of a counter
+ *
+ * \param counter Counter
+ * \return Name of the counter, in lower case
+ */
+const char *counter_name(Counter counter) noexcept;
+
+/**
+ * \brief Time spent in each stage of the keyword extraction, and counters of the processed items
+ *
+ * Both the wall-clock time and the CPU time of the calling thread are measured. A profile is filled by a single thread: profiles of several documents or threads are combined with the += operator. Components which accept a profile do not measure anything when they are given a null pointer, so that the instrumentation costs nothing when it is not used.
+ */
+class Profile {
+	public:
+		/**
+		 * \brief Measure of the time spent in a stage until the end of the scope
+		 */
+		class Scope {
+			public:
+				/**
+				 * \brief Start the measure
+				 *
+				 * \param profile Profile to which the time is added, or nullptr to measure nothing
+				 * \param stage Measured stage
+				 */
+				Scope(Profile *profile,Stage stage) noexcept:_profile(profile),_stage(stage) {
+					if (_profile==nullptr) return;
+					_wall=std::chrono::steady_clock::now();
+					_cpu=cpu_time();
+				}
+
+				Scope(const Scope&)=delete; 	//!< A measure can not be copied
+				Scope& operator=(const Scope&)=delete; 	//!< A measure can not be copied
+
+				/**
+				 * \brief Add the time spent since the start of the measure to the profile
+				 */
+				~Scope() {
+					if (_profile==nullptr) return;
+					_profile->add(_stage,std::chrono::duration<double>(std::chrono::steady_clock::now()-_wall).count(),cpu_time()-_cpu);
+				}
+
+			private:
+				Profile *_profile; 	//!< Profile to which the time is added
+				Stage _stage; 	//!< Measured stage
+				std::chrono::steady_clock::time_point _wall; 	//!< Wall-clock time at the start of the measure
+				double _cpu; 	//!< CPU time of the thread at the start of the measure, in seconds
+		};
+
+		/**
+		 * \brief Create an empty profile
+		 */
+		Profile() noexcept:_wall{},_cpu{},_counters{} {}
+
+		/**
+		 * \brief Add some time to a stage
+		 *
+		 * \param stage Stage
+		 * \param wall Wall-clock time, in seconds
+		 * \param cpu CPU time, in seconds
+		 */
+		void add(Stage stage,double wall,double cpu) noexcept {
+			_wall[int(stage)]+=wall;
+			_cpu[int(stage)]+=cpu;
+		}
+
+		/**
+		 * \brief Increment a counter
+		 *
+		 * \param counter Counter
+		 * \param n Increment
+		 */
+		void count(Counter counter,uint64_t n=1) noexcept {_counters[int(counter)]+=n;}
+
+		/**
+		 * \brief Set the value of a counter
+		 *
+		 * This is used for the sizes, which must not be counted again each time they are measured.
+		 * \param counter Counter
+		 * \param n Value
+		 */
+		void set(Counter counter,uint64_t n) noexcept {_counters[int(counter)]=n;}
+
+		/**
+		 * \brief Wall-clock time spent in a stage, in seconds
+		 */
+		double wall(Stage stage) const noexcept {return _wall[int(stage)];}
+
+		/**
+		 * \brief CPU time spent in a stage, in seconds
+		 */
+		double cpu(Stage stage) const noexcept {return _cpu[int(stage)];}
+
+		/**
+		 * \brief Value of a counter
+		 */
+		uint64_t counter(Counter counter) const noexcept {return _counters[int(counter)];}
+
+		/**
+		 * \brief Add the times and counters of another profile
+		 *
+		 * \param other Other profile
+		 * \return Reference to the profile
+		 */
+		Profile &operator+=(const Profile &other) noexcept;
+
+		/**
+		 * \brief Print a summary of the profile, one line per stage and per counter
+		 *
+		 * \param out Output stream
+		 */
+		void print(std::ostream &out) const;
+
+		/**
+		 * \brief CPU time of the calling thread, in seconds
+		 */
+		static double cpu_time() noexcept {
+			timespec ts;
+			clock_gettime(CLOCK_THREAD_CPUTIME_ID,&ts);
+			return ts.tv_sec+ts.tv_nsec*1e-9;
+		}
+
+	private:
+		std::array<double,STAGES> _wall; 	//!< Wall-clock time of each stage, in seconds
+		std::array<double,STAGES> _cpu; 	//!< CPU time of each stage, in seconds
+		std::array<uint64_t,COUNTERS> _counters; 	//!< Value of each counter
+};
+
+#endif   /* ----- #ifndef PROFILE_INC  ----- */
@@ -0,0 +1,177 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  server.cpp
+ *
+ *    Description:  Implementation of the keyword extraction server
+ *
+ *        Version:  1.0
+ *        Created:  19/10/2026 09:40:18
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  François Hissel
+ *   Organization:
+ *
+ * =====================================================================================
+ */
+
+#include <iostream>
+#include <streambuf>
+#include <string>
+#include <list>
+#include <thread>
+#include <mutex>
+#include <stdexcept>
+#include <cstring>
+#include <cerrno>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <unistd.h>
+#include "dictionary.h"
+#include "document.h"
+#include "pipeline.h"
+#include "server.h"
+
+using namespace std;
+
+/*********************************************
+ *             Socket_buffer                 *
+ *********************************************/
+/**
+ * \brief Stream buffer reading from or writing to a socket
+ *
+ * The buffer does not own the socket. A connection uses one buffer for its input stream and another one for its output stream, because they are used by different threads.
+ */
+class Socket_buffer:public streambuf {
+	public:
+		/**
+		 * \brief Create the buffer
+		 *
+		 * \param fd Socket
+		 */
+		explicit Socket_buffer(int fd):_fd(fd) {
+			setg(_buffer,_buffer,_buffer);
+			setp(_buffer,_buffer+sizeof(_buffer));
+		}
+
+		~Socket_buffer() override {sync();}
+
+	protected:
+		int_type underflow() override {
+			ssize_t len;
+			do len=read(_fd,_buffer,sizeof(_buffer)); while (len<0 && errno==EINTR);
+			if (len<=0) return traits_type::eof();
+			setg(_buffer,_buffer,_buffer+len);
+			return traits_type::to_int_type(_buffer[0]);
+		}
+
+		int_type overflow(int_type c) override {
+			if (sync()!=0) return traits_type::eof();
+			if (!traits_type::eq_int_type(c,traits_type::eof())) {
+				*pptr()=traits_type::to_char_type(c);
+				pbump(1);
+			}
+			return traits_type::not_eof(c);
+		}
+
+		int sync() override {
+			const char *p=pbase();
+			while (p<pptr()) {
+				// MSG_NOSIGNAL: a client closing its connection must not kill the server with SIGPIPE
+				auto len=send(_fd,p,pptr()-p,MSG_NOSIGNAL);
+				if (len<0 && errno==EINTR) continue;
+				if (len<=0) {
+					setp(_buffer,_buffer+sizeof(_buffer));
+					return -1;
+				}
+				p+=len;
+			}
+			setp(_buffer,_buffer+sizeof(_buffer));
+			return 0;
+		}
+
+	private:
+		int _fd; 	//!< Socket
+		char _buffer[65536]; 	//!< Data read from or waiting to be written to the socket
+};
+
+/*********************************************
+ *                 Server                    *
+ *********************************************/
+Server::Server(const string &path,const Dictionary &dic,int window_size,const Rank_parameters &parameters,int threads,int max_iterations):_path(path),_dic(dic),_window_size(window_size),_parameters(parameters),_max_iterations(max_iterations),_fd(-1),_stop(0),_pool(threads) {
+	sockaddr_un address{};
+	address.sun_family=AF_UNIX;
+	if (path.size()>=sizeof(address.sun_path)) throw runtime_error("Socket path too long: "+path);
+	strcpy(address.sun_path,path.c_str());
+	_fd=socket(AF_UNIX,SOCK_STREAM|SOCK_CLOEXEC,0);
+	if (_fd<0) throw runtime_error(string("Unable to create socket: ")+strerror(errno));
+	unlink(path.c_str());
+	if (bind(_fd,reinterpret_cast<const sockaddr*>(&address),sizeof(address))<0 || listen(_fd,SOMAXCONN)<0) {
+		auto error=errno;
+		close(_fd);
+		throw runtime_error("Unable to listen on "+path+": "+strerror(error));
+	}
+}
+
+Server::~Server() {
+	close(_fd);
+	unlink(_path.c_str());
+	{
+		// Clients can not send requests anymore, but still get the responses of the pending ones
+		lock_guard<mutex> lock(_mutex);
+		for (auto &it:_connections) shutdown(it.fd,SHUT_RD);
+	}
+	for (auto &it:_connections) {
+		it.thread.join();
+		close(it.fd);
+	}
+}
+
+void Server::serve(Connection &connection) {
+	try {
+		Socket_buffer input(connection.fd);
+		Socket_buffer output(connection.fd);
+		istream in(&input);
+		ostream out(&output);
+		Document_reader reader(in,Input::JSONL,_max_iterations);
+		Pipeline pipeline(_dic,_window_size,_parameters,true,false,_pool);
+		pipeline.run(reader,out);
+	} catch (const exception &e) {
+		cerr << e.what() << '\n';
+	}
+	connection.finished=true;
+}
+
+void Server::reap() {
+	lock_guard<mutex> lock(_mutex);
+	for (auto it=_connections.begin();it!=_connections.end();) {
+		if (it->finished) {
+			it->thread.join();
+			close(it->fd);
+			it=_connections.erase(it);
+		} else ++it;
+	}
+}
+
+void Server::run() {
+	pollfd listener{_fd,POLLIN,0};
+	while (!_stop) {
+		// The timeout bounds the delay before a stop request is seen, whichever thread receives the signal
+		auto ready=poll(&listener,1,200);
+		if (ready<0 && errno!=EINTR) throw runtime_error(string("Unable to wait for connections: ")+strerror(errno));
+		reap();
+		if (ready<=0) continue;
+		int fd=accept4(_fd,nullptr,nullptr,SOCK_CLOEXEC);
+		if (fd<0) {
+			if (errno==EINTR || errno==ECONNABORTED || errno==EAGAIN) continue;
+			throw runtime_error(string("Unable to accept connection: ")+strerror(errno));
+		}
+		lock_guard<mutex> lock(_mutex);
+		auto &connection=_connections.emplace_back();
+		connection.fd=fd;
+		connection.thread=thread(&Server::serve,this,ref(connection));
+	}
+}
@@ -0,0 +1,110 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  server.h
+ *
+ *    Description:  Keyword extraction server listening on a Unix domain socket
+ *
+ *        Version:  1.0
+ *        Created:  19/10/2026 09:12:55
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  François Hissel
+ *   Organization:
+ *
+ * =====================================================================================
+ */
+
+#ifndef  SERVER_INC
+#define  SERVER_INC
+
+#include <string>
+#include <list>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <csignal>
+#include "graph.h"
+#include "thread_pool.h"
+#include "document.h"
+
+class Dictionary;
+
+/**
+ * \brief Keyword extraction server
+ *
+ * The server loads nothing by itself: it shares an already loaded dictionary between all its clients. It listens on a Unix domain socket, and each connection is a stream of requests in the JSONL format of the batch mode, one JSON object per line. Requests may be pipelined: a client may send many requests without waiting for the responses, which are sent back in the order of the requests as soon as they are ready. All the connections share the same pool of workers.
+ */
+class Server {
+	public:
+		/**
+		 * \brief Create the server and bind its socket
+		 *
+		 * \param path Path of the Unix domain socket. An existing socket file at this path is replaced
+		 * \param dic Dictionary shared by all the requests
+		 * \param window_size Default size of the window for linked edges
+		 * \param parameters Default parameters of the TextRank algorithm
+		 * \param threads Number of worker threads. If it is 0, the number of hardware threads is used
+		 * \param max_iterations Largest number of iterations a request may ask for. A request which asks for more gets an error record
+		 * \throw std::runtime_error if the socket can not be created
+		 */
+		Server(const std::string &path,const Dictionary &dic,int window_size,const Rank_parameters &parameters,int threads=0,int max_iterations=MAX_REQUEST_ITERATIONS);
+
+		Server(const Server&)=delete; 	//!< A server can not be copied
+		Server& operator=(const Server&)=delete; 	//!< A server can not be copied
+
+		/**
+		 * \brief Close the socket, remove its file and wait for the connections to end
+		 */
+		~Server();
+
+		/**
+		 * \brief Accept connections until the server is stopped
+		 *
+		 * \throw std::runtime_error if the server can not accept connections anymore
+		 */
+		void run();
+
+		/**
+		 * \brief Stop the server
+		 *
+		 * The function only sets a flag and may be called from a signal handler. The run method returns within 200 ms. Connections in progress are closed by the destructor after their pending responses are sent.
+		 */
+		void stop() noexcept {_stop=true;}
+
+	private:
+		/**
+		 * \brief Connection of a client
+		 */
+		struct Connection {
+			int fd; 	//!< Socket of the connection
+			std::thread thread; 	//!< Thread reading the requests of the connection
+			std::atomic<bool> finished{false}; 	//!< Tell if the connection is closed and its thread may be joined
+		};
+
+		std::string _path; 	//!< Path of the socket
+		const Dictionary &_dic; 	//!< Dictionary shared by the requests
+		int _window_size; 	//!< Default size of the window
+		Rank_parameters _parameters; 	//!< Default parameters of the TextRank algorithm
+		int _max_iterations; 	//!< Largest number of iterations a request may ask for
+		int _fd; 	//!< Listening socket
+		volatile sig_atomic_t _stop; 	//!< Tell the server to stop
+		std::list<Connection> _connections; 	//!< Open connections
+		std::mutex _mutex; 	//!< Mutex protecting the list of connections
+		Thread_pool _pool; 	//!< Workers shared by all the connections
+
+		/**
+		 * \brief Serve the requests of a connection until the client closes it
+		 *
+		 * \param connection Connection
+		 */
+		void serve(Connection &connection);
+
+		/**
+		 * \brief Join the threads of the closed connections
+		 */
+		void reap();
+};
+
+#endif   /* ----- #ifndef SERVER_INC  ----- */
@@ -0,0 +1,385 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  textrank.cpp
+ *
+ *    Description:  Implementation of the C interface of the textrank library
+ *
+ *        Version:  1.0
+ *        Created:  21/10/2026 09:12:37
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  François Hissel
+ *   Organization:
+ *
+ * =====================================================================================
+ */
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <algorithm>
+#include <stdexcept>
+#include <new>
+#include <cstring>
+#include "dictionary.h"
+#include "arena.h"
+#include "profile.h"
+#include "word_cache.h"
+#include "thread_pool.h"
+#include "graph.h"
+#include "textrank.h"
+
+using namespace std;
+
+static_assert(TEXTRANK_STAGES==STAGES,"The stages of the C interface must be those of the profiles");
+static_assert(TEXTRANK_COUNTERS==COUNTERS,"The counters of the C interface must be those of the profiles");
+// The values of the enumerations of the C interface are those of the C++ ones, so that a program using both may convert them with a cast
+static_assert(TEXTRANK_LOOKUP_HASH==int(Lookup::HASH) && TEXTRANK_NORM_LINF==int(Norm::LINF) && TEXTRANK_PRECISION_FLOAT==int(Precision::FLOAT),"The enumerations of the C interface must match the C++ ones");
+static_assert(TEXTRANK_KERNEL_AVX512==int(Kernel::AVX512) && TEXTRANK_SOLVER_PUSH==int(Solver::PUSH),"The enumerations of the C interface must match the C++ ones");
+
+/**
+ * \brief Dictionary of the C interface
+ */
+struct textrank_dictionary {
+	Dictionary dic; 	//!< Mapped dictionary
+
+	/**
+	 * \brief Map the dictionary
+	 *
+	 * \param path Path name of the binary dictionary
+	 * \param method Lookup engine
+	 */
+	textrank_dictionary(const string &path,Lookup method):dic(path,method) {}
+};
+
+/**
+ * \brief Error raised when a function of the interface is called in a state of the extractor which does not allow it
+ */
+struct State_error:public logic_error {
+	using logic_error::logic_error;
+};
+
+/**
+ * \brief Extractor of the C interface
+ *
+ * The graph of the current text uses the arena and the cache of the extractor. The arena is reset when the graph is destroyed, so that the next texts reuse its memory.
+ */
+struct textrank_extractor {
+	const Dictionary &dic; 	//!< Dictionary
+	unique_ptr<Thread_pool> pool; 	//!< Threads sharing the iterations with the calling thread, or nullptr
+	Arena arena; 	//!< Memory of the runs and of the unknown lemmas of the graph
+	Word_cache cache; 	//!< Cache of the lookups in the dictionary
+	Profile profile; 	//!< Time and counters of the extractions run with the profile parameter
+	Rank_parameters parameters; 	//!< Parameters of the ranking of the current graph
+	unique_ptr<Graph> graph; 	//!< Graph of the current text or stream, or nullptr
+	bool finished=false; 	//!< True if the whole text of the stream has been appended
+	Ranking ranking; 	//!< Last ranking, holding the texts of the keywords
+	vector<textrank_keyword> keywords; 	//!< Keywords of the last ranking, pointing into its texts
+
+	/**
+	 * \brief Create the extractor
+	 *
+	 * \param dic Dictionary
+	 * \param threads Number of threads running the iterations, including the calling thread
+	 */
+	textrank_extractor(const Dictionary &dic,int threads):dic(dic),pool(threads>1?make_unique<Thread_pool>(threads-1):nullptr) {}
+
+	/**
+	 * \brief Destroy the graph of the current text or stream and release its memory in the arena
+	 */
+	void discard() noexcept {
+		graph.reset();
+		finished=false;
+		arena.reset();
+	}
+};
+
+/**
+ * \brief Message of the last error of the calling thread
+ */
+static thread_local string last_error;
+
+/**
+ * \brief Run a function of the interface, and convert its exceptions to a status
+ *
+ * \param fn Function, which returns the status of the call if it does not throw
+ * \return Status of the call
+ */
+template<class F> static textrank_status guard(F &&fn) noexcept {
+	try {
+		return fn();
+	} catch (const invalid_argument &e) {
+		last_error=e.what();
+		return TEXTRANK_ERROR_ARGUMENT;
+	} catch (const State_error &e) {
+		last_error=e.what();
+		return TEXTRANK_ERROR_STATE;
+	} catch (const bad_alloc &e) {
+		last_error="Not enough memory";
+		return TEXTRANK_ERROR_MEMORY;
+	} catch (const exception &e) {
+		last_error=e.what();
+		return TEXTRANK_ERROR_INTERNAL;
+	} catch (...) {
+		last_error="Unknown error";
+		return TEXTRANK_ERROR_INTERNAL;
+	}
+}
+
+/**
+ * \brief Set the parameters of the ranking of the extractor
+ *
+ * \param extractor Extractor
+ * \param parameters Parameters given by the caller, or nullptr for the default ones
+ * \return Parameters given by the caller, completed with the default values of the members its version of the structure does not have
+ * \throw std::invalid_argument if one of the parameters is invalid
+ */
+static textrank_parameters set_parameters(textrank_extractor &extractor,const textrank_parameters *parameters) {
+	textrank_parameters res;
+	textrank_default_parameters(&res);
+	if (parameters!=nullptr) {
+		if (parameters->size<sizeof(size_t)) throw invalid_argument("The parameters must be initialized by textrank_default_parameters");
+		memcpy(&res,parameters,min(parameters->size,sizeof(res)));
+		res.size=sizeof(res);
+	}
+	// Same bounds as the parameters of the requests of the batch mode
+	if (res.keywords<0) throw invalid_argument("The number of keywords must not be negative");
+	if (res.window<0) throw invalid_argument("The size of the window must not be negative");
+	if (res.iterations<0) throw invalid_argument("The number of iterations must not be negative");
+	if (!(res.damping>=0.0 && res.damping<=1.0)) throw invalid_argument("The damping coefficient must be between 0 and 1");
+	if (!(res.tolerance>=0.0)) throw invalid_argument("The tolerance must not be negative");
+	Rank_parameters param;
+	param.num_keywords=res.keywords;
+	param.max_iterations=res.iterations;
+	param.damping=res.damping;
+	param.tolerance=res.tolerance;
+	param.warm_start=(res.warm_start!=0);
+	param.pool=extractor.pool.get();
+	switch (res.norm) {
+		case TEXTRANK_NORM_L1:param.norm=Norm::L1;break;
+		case TEXTRANK_NORM_LINF:param.norm=Norm::LINF;break;
+		default:throw invalid_argument("Unknown norm");
+	}
+	switch (res.precision) {
+		case TEXTRANK_PRECISION_DOUBLE:param.precision=Precision::DOUBLE;break;
+		case TEXTRANK_PRECISION_FLOAT:param.precision=Precision::FLOAT;break;
+		default:throw invalid_argument("Unknown precision");
+	}
+	switch (res.kernel) {
+		case TEXTRANK_KERNEL_AUTO:param.kernel=Kernel::AUTO;break;
+		case TEXTRANK_KERNEL_SCALAR:param.kernel=Kernel::SCALAR;break;
+		case TEXTRANK_KERNEL_AVX2:param.kernel=Kernel::AVX2;break;
+		case TEXTRANK_KERNEL_AVX512:param.kernel=Kernel::AVX512;break;
+		default:throw invalid_argument("Unknown kernel");
+	}
+	switch (res.solver) {
+		case TEXTRANK_SOLVER_JACOBI:param.solver=Solver::JACOBI;break;
+		case TEXTRANK_SOLVER_GAUSS_SEIDEL:param.solver=Solver::GAUSS_SEIDEL;break;
+		case TEXTRANK_SOLVER_AITKEN:param.solver=Solver::AITKEN;break;
+		case TEXTRANK_SOLVER_PUSH:param.solver=Solver::PUSH;break;
+		default:throw invalid_argument("Unknown solver");
+	}
+	extractor.parameters=param;
+	return res;
+}
+
+/**
+ * \brief Rank the graph of the extractor and store the keywords in the extractor
+ *
+ * \param extractor Extractor, which must have a graph
+ * \param result Result of the ranking
+ */
+static void rank_graph(textrank_extractor &extractor,textrank_result &result) {
+	extractor.ranking=extractor.graph->text_rank(extractor.parameters);
+	extractor.keywords.clear();
+	result.size=0;
+	for (const auto &[word,score]:extractor.ranking) {
+		extractor.keywords.push_back(textrank_keyword{word.c_str(),word.size(),score});
+		result.size+=word.size()+1;
+	}
+	result.keywords=extractor.keywords.data();
+	result.count=extractor.keywords.size();
+	result.iterations=extractor.ranking.iterations;
+	result.residual=extractor.ranking.residual;
+	result.traversals=extractor.ranking.traversals;
+}
+
+/**
+ * \brief Build the graph of a whole text in the extractor and rank it
+ *
+ * \param extractor Extractor
+ * \param text UTF-8 encoded text
+ * \param length Length of the text in bytes
+ * \param parameters Parameters given by the caller, or nullptr
+ * \param result Result of the ranking
+ */
+static void extract_text(textrank_extractor &extractor,const char *text,size_t length,const textrank_parameters *parameters,textrank_result &result) {
+	if (text==nullptr && length>0) throw invalid_argument("The text is a null pointer");
+	extractor.discard();
+	auto param=set_parameters(extractor,parameters);
+	auto profile=param.profile?&extractor.profile:nullptr;
+	string_view view(text,length);
+	if (param.sentences==0) extractor.graph=make_unique<Graph>(view,extractor.dic,param.window,&extractor.arena,profile,&extractor.cache);
+	else {
+		extractor.graph=make_unique<Graph>(extractor.dic,param.window,param.sentences,&extractor.arena,profile,&extractor.cache);
+		extractor.graph->append(view);
+		extractor.graph->finish();
+	}
+	extractor.finished=true;
+	rank_graph(extractor,result);
+}
+
+/**
+ * \brief Function called by the graph after each sentence, which calls the function of the caller
+ *
+ * \param extractor Extractor
+ * \param on_sentence Function of the caller, or nullptr
+ * \param user Pointer given to the function of the caller
+ * \return Function given to the graph
+ */
+static function<void()> sentence_function(textrank_extractor *extractor,textrank_sentence_callback on_sentence,void *user) {
+	if (on_sentence==nullptr) return nullptr;
+	return [=]() {on_sentence(extractor,user);};
+}
+
+/*********************************************
+ *                Interface                  *
+ *********************************************/
+int textrank_version(void) {
+	return TEXTRANK_VERSION;
+}
+
+const char *textrank_last_error(void) {
+	return last_error.c_str();
+}
+
+void textrank_default_parameters(textrank_parameters *parameters) {
+	if (parameters==nullptr) return;
+	Rank_parameters defaults;
+	*parameters=textrank_parameters{sizeof(textrank_parameters),defaults.num_keywords,3,0,defaults.max_iterations,defaults.damping,defaults.tolerance,TEXTRANK_NORM_L1,TEXTRANK_PRECISION_DOUBLE,TEXTRANK_KERNEL_AUTO,TEXTRANK_SOLVER_JACOBI,0,0};
+}
+
+textrank_status textrank_dictionary_open(const char *path,textrank_lookup lookup,textrank_dictionary **dictionary) {
+	return guard([&]() {
+		if (path==nullptr || dictionary==nullptr) throw invalid_argument("Null pointer given to textrank_dictionary_open");
+		*dictionary=nullptr;
+		Lookup method;
+		switch (lookup) {
+			case TEXTRANK_LOOKUP_AUTO:method=Lookup::AUTO;break;
+			case TEXTRANK_LOOKUP_SEARCH:method=Lookup::SEARCH;break;
+			case TEXTRANK_LOOKUP_HASH:method=Lookup::HASH;break;
+			default:throw invalid_argument("Unknown lookup engine");
+		}
+		try {
+			*dictionary=new textrank_dictionary(path,method);
+		} catch (const runtime_error &e) {
+			last_error=e.what();
+			return TEXTRANK_ERROR_DICTIONARY;
+		}
+		return TEXTRANK_OK;
+	});
+}
+
+void textrank_dictionary_close(textrank_dictionary *dictionary) {
+	delete dictionary;
+}
+
+textrank_status textrank_extractor_create(const textrank_dictionary *dictionary,int threads,textrank_extractor **extractor) {
+	return guard([&]() {
+		if (dictionary==nullptr || extractor==nullptr) throw invalid_argument("Null pointer given to textrank_extractor_create");
+		*extractor=nullptr;
+		*extractor=new textrank_extractor(dictionary->dic,threads);
+		return TEXTRANK_OK;
+	});
+}
+
+void textrank_extractor_destroy(textrank_extractor *extractor) {
+	delete extractor;
+}
+
+textrank_status textrank_extract(textrank_extractor *extractor,const char *text,size_t length,const textrank_parameters *parameters,textrank_result *result) {
+	return guard([&]() {
+		if (extractor==nullptr || result==nullptr) throw invalid_argument("Null pointer given to textrank_extract");
+		extract_text(*extractor,text,length,parameters,*result);
+		return TEXTRANK_OK;
+	});
+}
+
+textrank_status textrank_extract_to(textrank_extractor *extractor,const char *text,size_t length,const textrank_parameters *parameters,textrank_keyword *keywords,size_t capacity,char *buffer,size_t size,textrank_result *result) {
+	return guard([&]() {
+		if (extractor==nullptr || result==nullptr || (keywords==nullptr && capacity>0) || (buffer==nullptr && size>0)) throw invalid_argument("Null pointer given to textrank_extract_to");
+		extract_text(*extractor,text,length,parameters,*result);
+		if (result->count>capacity || result->size>size) {
+			result->keywords=nullptr;
+			last_error="The memory given for the keywords is too small";
+			return TEXTRANK_ERROR_SPACE;
+		}
+		for (size_t i=0;i<result->count;++i) {
+			const auto &it=result->keywords[i];
+			memcpy(buffer,it.text,it.length+1);
+			keywords[i]=textrank_keyword{buffer,it.length,it.score};
+			buffer+=it.length+1;
+		}
+		result->keywords=keywords;
+		return TEXTRANK_OK;
+	});
+}
+
+textrank_status textrank_begin(textrank_extractor *extractor,const textrank_parameters *parameters) {
+	return guard([&]() {
+		if (extractor==nullptr) throw invalid_argument("Null pointer given to textrank_begin");
+		extractor->discard();
+		auto param=set_parameters(*extractor,parameters);
+		extractor->graph=make_unique<Graph>(extractor->dic,param.window,param.sentences,&extractor->arena,param.profile?&extractor->profile:nullptr,&extractor->cache);
+		return TEXTRANK_OK;
+	});
+}
+
+textrank_status textrank_append(textrank_extractor *extractor,const char *chunk,size_t length,textrank_sentence_callback on_sentence,void *user) {
+	return guard([&]() {
+		if (extractor==nullptr || (chunk==nullptr && length>0)) throw invalid_argument("Null pointer given to textrank_append");
+		if (extractor->graph==nullptr) throw State_error("No stream was started");
+		if (extractor->finished) throw State_error("The stream was already finished");
+		extractor->graph->append(string_view(chunk,length),sentence_function(extractor,on_sentence,user));
+		return TEXTRANK_OK;
+	});
+}
+
+textrank_status textrank_finish(textrank_extractor *extractor,textrank_sentence_callback on_sentence,void *user) {
+	return guard([&]() {
+		if (extractor==nullptr) throw invalid_argument("Null pointer given to textrank_finish");
+		if (extractor->graph==nullptr) throw State_error("No stream was started");
+		extractor->graph->finish(sentence_function(extractor,on_sentence,user));
+		extractor->finished=true;
+		return TEXTRANK_OK;
+	});
+}
+
+textrank_status textrank_rank(textrank_extractor *extractor,textrank_result *result) {
+	return guard([&]() {
+		if (extractor==nullptr || result==nullptr) throw invalid_argument("Null pointer given to textrank_rank");
+		if (extractor->graph==nullptr) throw State_error("No stream was started");
+		rank_graph(*extractor,*result);
+		return TEXTRANK_OK;
+	});
+}
+
+size_t textrank_sentences(const textrank_extractor *extractor) {
+	return (extractor==nullptr || extractor->graph==nullptr)?0:extractor->graph->sentences();
+}
+
+textrank_status textrank_extractor_profile(const textrank_extractor *extractor,textrank_profile *profile) {
+	return guard([&]() {
+		if (extractor==nullptr || profile==nullptr) throw invalid_argument("Null pointer given to textrank_extractor_profile");
+		for (int i=0;i<STAGES;++i) {
+			profile->wall[i]=extractor->profile.wall(Stage(i));
+			profile->cpu[i]=extractor->profile.cpu(Stage(i));
+		}
+		for (int i=0;i<COUNTERS;++i) profile->counters[i]=extractor->profile.counter(Counter(i));
+		return TEXTRANK_OK;
+	});
+}
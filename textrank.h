@@ -0,0 +1,317 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  textrank.h
+ *
+ *    Description:  C interface of the textrank library, which extracts the keywords of
+ *    				texts in memory without starting a process for each of them
+ *
+ *        Version:  1.0
+ *        Created:  21/10/2026 09:12:37
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  François Hissel
+ *   Organization:
+ *
+ * =====================================================================================
+ */
+
+#ifndef  TEXTRANK_INC
+#define  TEXTRANK_INC
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__GNUC__)
+#define TEXTRANK_API __attribute__((visibility("default")))
+#else
+#define TEXTRANK_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief Version of the interface. It is incremented when a function or a member is added, and the existing ones are never changed
+ */
+#define TEXTRANK_VERSION 1
+
+#define TEXTRANK_STAGES 6 	//!< Number of stages of a profile: load, tokenize, lookup, build, rank and phrases
+#define TEXTRANK_COUNTERS 11 	//!< Number of counters of a profile: tokens, hits, misses, folded, cache hits, cache misses, sentences, nodes, edges, iterations and traversals
+
+/**
+ * \brief Result of a function of the library
+ */
+typedef enum textrank_status {
+	TEXTRANK_OK=0, 	//!< Success
+	TEXTRANK_ERROR_ARGUMENT=1, 	//!< Null pointer or invalid parameter
+	TEXTRANK_ERROR_DICTIONARY=2, 	//!< The dictionary can not be opened, or is not a valid dictionary
+	TEXTRANK_ERROR_STATE=3, 	//!< The function can not be called in the current state of the extractor, for instance text appended before textrank_begin or after textrank_finish
+	TEXTRANK_ERROR_SPACE=4, 	//!< The memory given by the caller is too small for the result
+	TEXTRANK_ERROR_MEMORY=5, 	//!< Not enough memory
+	TEXTRANK_ERROR_INTERNAL=6 	//!< Any other error
+} textrank_status;
+
+/**
+ * \brief Lookup engine of the dictionary
+ */
+typedef enum textrank_lookup {
+	TEXTRANK_LOOKUP_AUTO=0, 	//!< Perfect hash table if the dictionary file has one, binary search otherwise
+	TEXTRANK_LOOKUP_SEARCH=1, 	//!< Binary search over the sorted words
+	TEXTRANK_LOOKUP_HASH=2 	//!< Minimal perfect hash table built by 'prepare'
+} textrank_lookup;
+
+/**
+ * \brief Norm of the residual
+ */
+typedef enum textrank_norm {
+	TEXTRANK_NORM_L1=0, 	//!< Sum of the absolute changes of all the scores
+	TEXTRANK_NORM_LINF=1 	//!< Largest absolute change of a score
+} textrank_norm;
+
+/**
+ * \brief Floating-point type of the scores during the iterations
+ */
+typedef enum textrank_precision {
+	TEXTRANK_PRECISION_DOUBLE=0, 	//!< 64-bit scores
+	TEXTRANK_PRECISION_FLOAT=1 	//!< 32-bit scores
+} textrank_precision;
+
+/**
+ * \brief Instruction set of the iterations
+ */
+typedef enum textrank_kernel {
+	TEXTRANK_KERNEL_AUTO=0, 	//!< Best instruction set supported by the processor
+	TEXTRANK_KERNEL_SCALAR=1, 	//!< Portable scalar code
+	TEXTRANK_KERNEL_AVX2=2, 	//!< AVX2 instructions
+	TEXTRANK_KERNEL_AVX512=3 	//!< AVX-512 instructions
+} textrank_kernel;
+
+/**
+ * \brief Method solving the equations of the scores
+ */
+typedef enum textrank_solver {
+	TEXTRANK_SOLVER_JACOBI=0, 	//!< Power iteration
+	TEXTRANK_SOLVER_GAUSS_SEIDEL=1, 	//!< Scores updated in place
+	TEXTRANK_SOLVER_AITKEN=2, 	//!< Power iteration with Aitken extrapolation
+	TEXTRANK_SOLVER_PUSH=3 	//!< Residuals pushed to the neighbours
+} textrank_solver;
+
+/**
+ * \brief Parameters of an extraction
+ *
+ * The structure must be initialized by textrank_default_parameters before its members are changed. Its first member holds its size, so that a program compiled with an older version of this header, whose structure has fewer members, still works with a newer library.
+ */
+typedef struct textrank_parameters {
+	size_t size; 	//!< Size of the structure, set by textrank_default_parameters
+	int keywords; 	//!< Number of keywords (default: 10)
+	int window; 	//!< Size of the window in which words are linked (default: 3)
+	size_t sentences; 	//!< Number of last sentences kept in the graph, 0 to keep all of them (default: 0)
+	int iterations; 	//!< Maximal number of iterations (default: 20)
+	double damping; 	//!< Damping coefficient (default: 0.85)
+	double tolerance; 	//!< The iterations stop as soon as the residual is lower or equal to this value, 0 to run all of them (default: 0)
+	textrank_norm norm; 	//!< Norm of the residual (default: L1)
+	textrank_precision precision; 	//!< Floating-point type of the scores during the iterations (default: double)
+	textrank_kernel kernel; 	//!< Instruction set of the iterations (default: auto)
+	textrank_solver solver; 	//!< Method solving the equations of the scores (default: Jacobi)
+	int warm_start; 	//!< If not 0, each ranking of a stream starts from the scores of the previous one (default: 0)
+	int profile; 	//!< If not 0, the time and counters of the stages are added to the profile of the extractor (default: 0)
+} textrank_parameters;
+
+/**
+ * \brief Keyword and its score
+ */
+typedef struct textrank_keyword {
+	const char *text; 	//!< UTF-8 encoded keyword, terminated by a null character
+	size_t length; 	//!< Length of the keyword in bytes, without the null character
+	double score; 	//!< Score of the keyword
+} textrank_keyword;
+
+/**
+ * \brief Result of an extraction
+ */
+typedef struct textrank_result {
+	const textrank_keyword *keywords; 	//!< Keywords, sorted by decreasing score
+	size_t count; 	//!< Number of keywords
+	size_t size; 	//!< Number of bytes of the texts of the keywords, including their null characters
+	int iterations; 	//!< Number of iterations actually run
+	double residual; 	//!< Change of the scores during the last iteration
+	uint64_t traversals; 	//!< Number of edges read by the iterations
+} textrank_result;
+
+/**
+ * \brief Time spent in each stage of the extractions, in seconds, and counters of the processed items
+ */
+typedef struct textrank_profile {
+	double wall[TEXTRANK_STAGES]; 	//!< Wall-clock time of each stage
+	double cpu[TEXTRANK_STAGES]; 	//!< CPU time of each stage
+	uint64_t counters[TEXTRANK_COUNTERS]; 	//!< Value of each counter
+} textrank_profile;
+
+/**
+ * \brief Dictionary mapped in memory. It is read-only and may be shared by any number of extractors in any number of threads
+ */
+typedef struct textrank_dictionary textrank_dictionary;
+
+/**
+ * \brief Extractor of keywords. It keeps its memory, its cache of the words and its threads from one text to the next, and may only be used by one thread at a time
+ */
+typedef struct textrank_extractor textrank_extractor;
+
+/**
+ * \brief Function called after each complete sentence of a stream has been added to the graph. It may call textrank_rank and textrank_sentences
+ *
+ * \param extractor Extractor of the stream
+ * \param user Pointer given to textrank_append or textrank_finish
+ */
+typedef void (*textrank_sentence_callback)(textrank_extractor *extractor,void *user);
+
+/**
+ * \brief Version of the library, which may be newer than TEXTRANK_VERSION if the program was compiled with an older header
+ */
+TEXTRANK_API int textrank_version(void);
+
+/**
+ * \brief Message of the last error of a function of the library in the calling thread
+ *
+ * \return Null-terminated message, valid until the next error in the same thread, or an empty string if no function failed yet
+ */
+TEXTRANK_API const char *textrank_last_error(void);
+
+/**
+ * \brief Initialize parameters with their default values
+ *
+ * \param parameters Parameters to initialize
+ */
+TEXTRANK_API void textrank_default_parameters(textrank_parameters *parameters);
+
+/**
+ * \brief Open a dictionary generated by 'prepare'
+ *
+ * \param path Path name of the binary dictionary
+ * \param lookup Lookup engine
+ * \param dictionary Address where the handle of the dictionary is stored
+ * \return TEXTRANK_OK, or TEXTRANK_ERROR_DICTIONARY if the file can not be opened, is not a valid dictionary or has no hash table while TEXTRANK_LOOKUP_HASH is requested
+ */
+TEXTRANK_API textrank_status textrank_dictionary_open(const char *path,textrank_lookup lookup,textrank_dictionary **dictionary);
+
+/**
+ * \brief Close a dictionary. Its extractors must have been destroyed
+ *
+ * \param dictionary Dictionary, or a null pointer
+ */
+TEXTRANK_API void textrank_dictionary_close(textrank_dictionary *dictionary);
+
+/**
+ * \brief Create an extractor of keywords
+ *
+ * \param dictionary Dictionary used by the extractor, which must outlive it
+ * \param threads Number of threads running the iterations of the Jacobi solver, including the calling thread. Values lower than 2 run them in the calling thread
+ * \param extractor Address where the handle of the extractor is stored
+ * \return TEXTRANK_OK or an error code
+ */
+TEXTRANK_API textrank_status textrank_extractor_create(const textrank_dictionary *dictionary,int threads,textrank_extractor **extractor);
+
+/**
+ * \brief Destroy an extractor
+ *
+ * \param extractor Extractor, or a null pointer
+ */
+TEXTRANK_API void textrank_extractor_destroy(textrank_extractor *extractor);
+
+/**
+ * \brief Extract the keywords of a text
+ *
+ * The keywords are held by the extractor, and are valid until its next call. A stream of the extractor which was not finished is discarded.
+ * \param extractor Extractor
+ * \param text UTF-8 encoded text, which does not need to be terminated by a null character
+ * \param length Length of the text in bytes
+ * \param parameters Parameters of the extraction, or a null pointer for the default ones
+ * \param result Address where the result is stored
+ * \return TEXTRANK_OK or an error code
+ */
+TEXTRANK_API textrank_status textrank_extract(textrank_extractor *extractor,const char *text,size_t length,const textrank_parameters *parameters,textrank_result *result);
+
+/**
+ * \brief Extract the keywords of a text into memory given by the caller
+ *
+ * The keywords are written to the keywords array and their texts to the buffer, so that they stay valid after the next calls to the extractor. A stream of the extractor which was not finished is discarded. If either of them is too small, nothing is written to them, and the count and size members of the result tell how much is needed.
+ * \param extractor Extractor
+ * \param text UTF-8 encoded text, which does not need to be terminated by a null character
+ * \param length Length of the text in bytes
+ * \param parameters Parameters of the extraction, or a null pointer for the default ones
+ * \param keywords Array receiving the keywords
+ * \param capacity Number of elements of the array
+ * \param buffer Buffer receiving the null-terminated texts of the keywords
+ * \param size Size of the buffer in bytes
+ * \param result Address where the result is stored. Its keywords member points to the array
+ * \return TEXTRANK_OK, TEXTRANK_ERROR_SPACE if the array or the buffer is too small, or another error code
+ */
+TEXTRANK_API textrank_status textrank_extract_to(textrank_extractor *extractor,const char *text,size_t length,const textrank_parameters *parameters,textrank_keyword *keywords,size_t capacity,char *buffer,size_t size,textrank_result *result);
+
+/**
+ * \brief Start a stream of text, which is then appended chunk by chunk
+ *
+ * A stream which was not finished is discarded.
+ * \param extractor Extractor
+ * \param parameters Parameters of the extraction, or a null pointer for the default ones
+ * \return TEXTRANK_OK or an error code
+ */
+TEXTRANK_API textrank_status textrank_begin(textrank_extractor *extractor,const textrank_parameters *parameters);
+
+/**
+ * \brief Append a chunk of text to the stream
+ *
+ * The chunk may end anywhere, even inside a word or a UTF-8 sequence: the incomplete sentence at its end is kept until the next chunks complete it.
+ * \param extractor Extractor
+ * \param chunk UTF-8 encoded chunk of text
+ * \param length Length of the chunk in bytes
+ * \param on_sentence Function called after each complete sentence, or a null pointer
+ * \param user Pointer given to the function
+ * \return TEXTRANK_OK, TEXTRANK_ERROR_STATE if no stream was started or if it was finished, or another error code
+ */
+TEXTRANK_API textrank_status textrank_append(textrank_extractor *extractor,const char *chunk,size_t length,textrank_sentence_callback on_sentence,void *user);
+
+/**
+ * \brief Add the incomplete sentence at the end of the stream. No more text may be appended
+ *
+ * \param extractor Extractor
+ * \param on_sentence Function called if the last sentence is added to the graph, or a null pointer
+ * \param user Pointer given to the function
+ * \return TEXTRANK_OK, TEXTRANK_ERROR_STATE if no stream was started, or another error code
+ */
+TEXTRANK_API textrank_status textrank_finish(textrank_extractor *extractor,textrank_sentence_callback on_sentence,void *user);
+
+/**
+ * \brief Extract the keywords of the sentences of the stream added so far
+ *
+ * The keywords are held by the extractor, and are valid until its next call.
+ * \param extractor Extractor
+ * \param result Address where the result is stored
+ * \return TEXTRANK_OK, TEXTRANK_ERROR_STATE if no stream was started, or another error code
+ */
+TEXTRANK_API textrank_status textrank_rank(textrank_extractor *extractor,textrank_result *result);
+
+/**
+ * \brief Number of sentences with at least one word added to the stream, or 0 if no stream was started
+ *
+ * \param extractor Extractor
+ */
+TEXTRANK_API size_t textrank_sentences(const textrank_extractor *extractor);
+
+/**
+ * \brief Time and counters of the stages of the extractions run with the profile parameter since the creation of the extractor
+ *
+ * \param extractor Extractor
+ * \param profile Address where the profile is stored
+ * \return TEXTRANK_OK or an error code
+ */
+TEXTRANK_API textrank_status textrank_extractor_profile(const textrank_extractor *extractor,textrank_profile *profile);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif   /* ----- #ifndef TEXTRANK_INC  ----- */
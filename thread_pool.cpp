@@ -0,0 +1,98 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  thread_pool.cpp
+ *
+ *    Description:  Implementation of the pool of worker threads
+ *
+ *        Version:  1.0
+ *        Created:  17/10/2026 14:31:52
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  François Hissel
+ *   Organization:
+ *
+ * =====================================================================================
+ */
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <memory>
+#include <algorithm>
+#include "thread_pool.h"
+
+using namespace std;
+
+/*********************************************
+ *               Thread_pool                 *
+ *********************************************/
+Thread_pool::Thread_pool(int threads):_stop(false) {
+	if (threads<=0) threads=max(1u,thread::hardware_concurrency());
+	_workers.reserve(threads);
+	for (int i=0;i<threads;++i) _workers.emplace_back(&Thread_pool::work,this);
+}
+
+Thread_pool::~Thread_pool() {
+	{
+		lock_guard<mutex> lock(_mutex);
+		_stop=true;
+	}
+	_condition.notify_all();
+	for (auto &it:_workers) it.join();
+}
+
+void Thread_pool::work() {
+	for (;;) {
+		function<void()> task;
+		{
+			unique_lock<mutex> lock(_mutex);
+			_condition.wait(lock,[this]{return _stop || !_tasks.empty();});
+			if (_tasks.empty()) return;
+			task=move(_tasks.front());
+			_tasks.pop_front();
+		}
+		task();
+	}
+}
+
+void Thread_pool::submit(function<void()> task) {
+	{
+		lock_guard<mutex> lock(_mutex);
+		_tasks.push_back(move(task));
+	}
+	_condition.notify_one();
+}
+
+void Thread_pool::parallel_for(int count,const function<void(int)> &fn) {
+	if (count<=0) return;
+	// State shared with the helpers. It outlives this call if a helper starts after all the indices have been handed out
+	struct Loop {
+		atomic<int> next{0};
+		int done=0;
+		mutex m;
+		condition_variable finished;
+	};
+	auto loop=make_shared<Loop>();
+	auto run=[loop,count,&fn]() {
+		int finished=0;
+		for (int i=loop->next++;i<count;i=loop->next++) {
+			fn(i);
+			++finished;
+		}
+		if (finished>0) {
+			lock_guard<mutex> lock(loop->m);
+			loop->done+=finished;
+			if (loop->done==count) loop->finished.notify_all();
+		}
+	};
+	int helpers=min(size(),count-1);
+	for (int i=0;i<helpers;++i) submit(run);
+	run();
+	unique_lock<mutex> lock(loop->m);
+	loop->finished.wait(lock,[&]{return loop->done==count;});
+}
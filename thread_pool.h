@@ -0,0 +1,87 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  thread_pool.h
+ *
+ *    Description:  Pool of worker threads
+ *
+ *        Version:  1.0
+ *        Created:  17/10/2026 14:20:11
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  François Hissel
+ *   Organization:
+ *
+ * =====================================================================================
+ */
+
+#ifndef  THREAD_POOL_INC
+#define  THREAD_POOL_INC
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+/**
+ * \brief Pool of worker threads
+ *
+ * The pool runs tasks submitted from any thread. Its workers are created once and reused, so that parallel loops do not pay for thread creation.
+ */
+class Thread_pool {
+	public:
+		/**
+		 * \brief Create the pool
+		 *
+		 * \param threads Number of worker threads. If it is 0, the number of hardware threads is used
+		 */
+		explicit Thread_pool(int threads=0);
+
+		Thread_pool(const Thread_pool&)=delete; 	//!< A pool can not be copied
+		Thread_pool& operator=(const Thread_pool&)=delete; 	//!< A pool can not be copied
+
+		/**
+		 * \brief Destroy the pool
+		 *
+		 * Pending tasks are run before the workers are joined.
+		 */
+		~Thread_pool();
+
+		/**
+		 * \brief Number of worker threads
+		 */
+		int size() const noexcept {return int(_workers.size());}
+
+		/**
+		 * \brief Submit a task to the pool
+		 *
+		 * \param task Task, which will be run by one of the workers
+		 */
+		void submit(std::function<void()> task);
+
+		/**
+		 * \brief Run a parallel loop
+		 *
+		 * The function is called once for each index, from the workers and from the calling thread, and returns when all the calls are finished. Indices are handed out dynamically, so the caller must not rely on which thread runs which index.
+		 * \param count Number of indices
+		 * \param fn Function called with each index in [0,count)
+		 */
+		void parallel_for(int count,const std::function<void(int)> &fn);
+
+	private:
+		std::vector<std::thread> _workers; 	//!< Worker threads
+		std::deque<std::function<void()>> _tasks; 	//!< Pending tasks
+		std::mutex _mutex; 	//!< Mutex protecting the queue of tasks
+		std::condition_variable _condition; 	//!< Condition signalled when a task is submitted or the pool is stopped
+		bool _stop; 	//!< Tell the workers to exit when the queue is empty
+
+		/**
+		 * \brief Main loop of a worker thread
+		 */
+		void work();
+};
+
+#endif   /* ----- #ifndef THREAD_POOL_INC  ----- */
@@ -0,0 +1,79 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  tokenizer.h
+ *
+ *    Description:  Tokenizer splitting a UTF-8 text in sentences and words
+ *
+ *        Version:  1.0
+ *        Created:  17/10/2026 17:45:19
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  François Hissel
+ *   Organization:
+ *
+ * =====================================================================================
+ */
+
+#ifndef  TOKENIZER_INC
+#define  TOKENIZER_INC
+
+#include <string_view>
+#include <cstdint>
+
+/**
+ * \brief Tell if a character may belong to a word
+ *
+ * Letters and digits of the whole Unicode range belong to words, as classified by the C.UTF-8 locale. The hyphen and all other characters are separators. The classification is table-driven and does not depend on the current locale.
+ * \param c Unicode code point
+ * \return True if the character belongs to words
+ */
+bool is_word_char(char32_t c) noexcept;
+
+/**
+ * \brief Type of the elements returned by the tokenizer
+ */
+enum class Token {
+	WORD, 	//!< A word
+	SENTENCE, 	//!< The end of a sentence
+	END 	//!< The end of the text
+};
+
+/**
+ * \brief Tokenizer of a UTF-8 text
+ *
+ * The tokenizer scans a UTF-8 buffer without copying it. Sentences are delimited by dots and newline characters. Inside a sentence, words are the longest sequences of letters and digits, all other characters being separators. Invalid UTF-8 sequences are considered as separators.
+ */
+class Tokenizer {
+	public:
+		/**
+		 * \brief Create a tokenizer on a text
+		 *
+		 * \param text UTF-8 encoded text, which must outlive the tokenizer
+		 */
+		explicit Tokenizer(std::string_view text) noexcept:_text(text),_pos(0),_finished(false) {}
+
+		/**
+		 * \brief Get the next element of the text
+		 *
+		 * The end of each sentence, including the last one, is reported with Token::SENTENCE before Token::END is returned.
+		 * \param word Next word, only set if the function returns Token::WORD. The view points into the text
+		 * \return Type of the element
+		 */
+		Token next(std::string_view &word) noexcept;
+
+		/**
+		 * \brief Position of the tokenizer in the text
+		 *
+		 * \return Number of bytes already consumed
+		 */
+		std::size_t position() const noexcept {return _pos;}
+
+	private:
+		std::string_view _text; 	//!< Text
+		std::size_t _pos; 	//!< Position of the next byte to read
+		bool _finished; 	//!< Tell if the end of the last sentence has already been reported
+};
+
+#endif   /* ----- #ifndef TOKENIZER_INC  ----- */
@@ -0,0 +1,60 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  utf8.h
+ *
+ *    Description:  Conversion of UTF-8 strings to wide strings. The programs work on
+ *    				UTF-8 strings, only the legacy tokenizer of the benchmark needs it
+ *
+ *        Version:  1.0
+ *        Created:  17/10/2026 09:40:05
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  François Hissel
+ *   Organization:
+ *
+ * =====================================================================================
+ */
+
+#ifndef  UTF8_INC
+#define  UTF8_INC
+
+#include <string>
+#include <string_view>
+
+/**
+ * \brief Decode a UTF-8 string into a wide string
+ *
+ * Invalid or truncated sequences are replaced by the replacement character U+FFFD.
+ * \param s UTF-8 encoded string
+ * \return Wide string
+ */
+inline std::wstring from_utf8(std::string_view s) {
+	std::wstring res;
+	res.reserve(s.size());
+	std::string_view::size_type i=0;
+	while (i<s.size()) {
+		auto c=(unsigned char)(s[i]);
+		int len;
+		unsigned long cp;
+		if (c<0x80) {len=1;cp=c;}
+		else if ((c&0xE0)==0xC0) {len=2;cp=c&0x1F;}
+		else if ((c&0xF0)==0xE0) {len=3;cp=c&0x0F;}
+		else if ((c&0xF8)==0xF0) {len=4;cp=c&0x07;}
+		else {res.push_back(L'\xFFFD');++i;continue;}
+		if (i+len>s.size()) {res.push_back(L'\xFFFD');break;}
+		bool valid=true;
+		for (int k=1;k<len;++k) {
+			auto cc=(unsigned char)(s[i+k]);
+			if ((cc&0xC0)!=0x80) {valid=false;break;}
+			cp=(cp<<6)|(cc&0x3F);
+		}
+		if (!valid) {res.push_back(L'\xFFFD');++i;continue;}
+		res.push_back(wchar_t(cp));
+		i+=len;
+	}
+	return res;
+}
+
+#endif   /* ----- #ifndef UTF8_INC  ----- */
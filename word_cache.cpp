@@ -0,0 +1,73 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  word_cache.cpp
+ *
+ *    Description:  Implementation of the cache of the words looked up in the dictionary
+ *
+ *        Version:  1.0
+ *        Created:  21/10/2026 10:04:55
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  François Hissel
+ *   Organization:
+ *
+ * =====================================================================================
+ */
+
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include "format.h"
+#include "dictionary.h"
+#include "word_cache.h"
+
+using namespace std;
+
+/*********************************************
+ *               Word_cache                  *
+ *********************************************/
+Word_cache::Word_cache(size_t capacity) noexcept:_capacity(2),_dic(0),_hits(0),_misses(0) {
+	while (_capacity<capacity) _capacity*=2;
+}
+
+void Word_cache::clear() noexcept {
+	for (auto &it:_slots) it.length=0;
+}
+
+Word_cache::Value Word_cache::lookup(string_view word,const Dictionary &dic) {
+	static_assert(sizeof(Slot)==64,"A slot of the cache must fill a cache line");
+	if (_dic!=dic.id()) {
+		clear();
+		_dic=dic.id();
+	}
+	if (word.size()>sizeof(Slot::word)) {
+		++_misses;
+		auto entry=dic.lookup_folded(word);
+		if (entry==-1) return Value{-1,-1,Pos::UNKNOWN};
+		return Value{entry,dic.lemma(entry),dic.pos(entry)};
+	}
+	if (_slots.empty()) _slots.resize(_capacity,Slot{-1,-1,Pos::UNKNOWN,0,{}});
+	auto set=_slots.data()+(hash_word(word)&(_capacity/2-1))*2;
+	auto match=[&word](const Slot &slot) {return slot.length==word.size() && equal(word.begin(),word.end(),slot.word);};
+	if (match(set[0])) {
+		++_hits;
+		return Value{set[0].entry,set[0].lemma,set[0].pos};
+	}
+	if (match(set[1])) {
+		// A word found a second time is promoted to the protected slot of the set
+		++_hits;
+		swap(set[0],set[1]);
+		return Value{set[0].entry,set[0].lemma,set[0].pos};
+	}
+	++_misses;
+	auto entry=dic.lookup_folded(word);
+	auto &slot=set[1];
+	slot.entry=entry;
+	slot.lemma=(entry!=-1)?dic.lemma(entry):-1;
+	slot.pos=(entry!=-1)?dic.pos(entry):Pos::UNKNOWN;
+	slot.length=uint8_t(word.size());
+	copy(word.begin(),word.end(),slot.word);
+	return Value{slot.entry,slot.lemma,slot.pos};
+}
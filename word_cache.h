@@ -0,0 +1,100 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  word_cache.h
+ *
+ *    Description:  Cache of the most frequent words looked up in the dictionary
+ *
+ *        Version:  1.0
+ *        Created:  21/10/2026 09:37:12
+ *       Revision:  none
+ *       Compiler:  g++
+ *
+ *         Author:  François Hissel
+ *   Organization:
+ *
+ * =====================================================================================
+ */
+
+#ifndef  WORD_CACHE_INC
+#define  WORD_CACHE_INC
+
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "dictionary.h"
+
+/**
+ * \brief Cache of the results of the lookups in the dictionary
+ *
+ * Natural texts follow Zipf's law: a few thousand words make most of their occurrences. The cache keeps the result of the lookup of these words, including the words which are not in the dictionary, in a small table which stays in the L1 and L2 caches of the processor, whereas each lookup in the dictionary reads its hash tables, its string pool, its tags and its lemmas at random places.
+ *
+ * The table is made of sets of two slots, the set of a word being given by its hash. A new word replaces the second slot of its set, and a word found in the second slot is swapped with the first one, so that the words which are seen only once, which make the long tail of the law, never evict a frequent word. Each slot fills a cache line, and holds a copy of the word, so that a hit does not read the dictionary at all. Words longer than the space of a slot are always looked up in the dictionary. The cache is not thread-safe: each thread uses its own cache, which may be kept from one document to the next. It is emptied when it is used with another dictionary.
+ */
+class Word_cache {
+	public:
+		/**
+		 * \brief Result of the lookup of a word
+		 */
+		struct Value {
+			int32_t entry; 	//!< Entry of the word, or of its lower-case version, in the dictionary, or -1 if neither is found
+			int32_t lemma; 	//!< Entry of the lemma of the word, or -1 if the word is not found
+			Pos pos; 	//!< POS tag of the word, Pos::UNKNOWN if it is not found
+		};
+
+		/**
+		 * \brief Create an empty cache
+		 *
+		 * The table is only allocated at the first lookup.
+		 * \param capacity Number of slots of the table, rounded up to a power of 2. The default table takes 256 KiB
+		 */
+		explicit Word_cache(std::size_t capacity=4096) noexcept;
+
+		/**
+		 * \brief Look for a word or its lower-case version in the dictionary
+		 *
+		 * The result is the same as the one of Dictionary::lookup_folded.
+		 * \param word UTF-8 encoded word
+		 * \param dic Dictionary
+		 * \return Result of the lookup
+		 */
+		Value lookup(std::string_view word,const Dictionary &dic);
+
+		/**
+		 * \brief Empty the cache
+		 *
+		 * The counters are not reset.
+		 */
+		void clear() noexcept;
+
+		/**
+		 * \brief Number of lookups found in the cache
+		 */
+		uint64_t hits() const noexcept {return _hits;}
+
+		/**
+		 * \brief Number of lookups which had to read the dictionary
+		 */
+		uint64_t misses() const noexcept {return _misses;}
+
+	private:
+		/**
+		 * \brief Slot of the table, which fills a cache line
+		 */
+		struct alignas(64) Slot {
+			int32_t entry; 	//!< Entry of the word
+			int32_t lemma; 	//!< Entry of the lemma of the word
+			Pos pos; 	//!< POS tag of the word
+			uint8_t length; 	//!< Length of the word in bytes, 0 if the slot is empty
+			char word[64-3*sizeof(int32_t)-1]; 	//!< Bytes of the word
+		};
+
+		std::vector<Slot> _slots; 	//!< Table, empty until the first lookup
+		std::size_t _capacity; 	//!< Number of slots of the table
+		uint64_t _dic; 	//!< Identifier of the dictionary of the cached results, 0 if it is not set yet
+		uint64_t _hits; 	//!< Number of lookups found in the cache
+		uint64_t _misses; 	//!< Number of lookups which had to read the dictionary
+};
+
+#endif   /* ----- #ifndef WORD_CACHE_INC  ----- */